@@ -1,3 +1,90 @@
 # pragma once
 
-#define CAN_DEVICE_HANDLE_RESPONSE_ENABLE 1
\ No newline at end of file
+#define CAN_DEVICE_HANDLE_RESPONSE_ENABLE 1
+
+// 总线位速率(bit/s)，与 CANInterface::init 中的配置保持一致
+#define CAN_BUS_BITRATE 1000000
+// 总线负载统计窗口(毫秒)
+#define CAN_BUS_LOAD_WINDOW_MS 100
+// 总线负载高于此值时遥测降频，低于低水位时逐级恢复
+#define CAN_BUS_LOAD_HIGH_WATERMARK 0.70
+#define CAN_BUS_LOAD_LOW_WATERMARK 0.50
+// 遥测帧基准速率(帧/秒)：每设备 / 全总线
+#define CAN_TELEMETRY_DEVICE_RATE 200.0
+#define CAN_TELEMETRY_BUS_RATE 2000.0
+// 读取缓存有效期(毫秒)：有效期内重复读取同一状态不再访问总线，0 表示不缓存
+#define CAN_READ_CACHE_TTL_MS 20
+// 每个电机的遥测广播环容量(条，2的幂)，订阅者落后超过此条数时丢弃最旧的数据
+#define TELEMETRY_RING_CAPACITY 256
+
+// 编译期日志级别下限(0=DEBUG 1=INFO 2=WARNING 3=ERROR 4=CRITICAL)，低于此级别的日志调用不产生任何代码
+// Release 构建由 CMakeLists.txt 设置为 1
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL 0
+#endif
+
+// 日志文件滚动：单个分段大小(字节)、分段数量（含当前分段）、单个分段最长写入时间(秒，0 表示只按大小滚动)
+// 每类日志的磁盘占用不超过 LOG_SEGMENT_SIZE * LOG_SEGMENT_COUNT
+#ifndef LOG_SEGMENT_SIZE
+#define LOG_SEGMENT_SIZE (8 * 1024 * 1024)
+#endif
+#ifndef LOG_SEGMENT_COUNT
+#define LOG_SEGMENT_COUNT 8
+#endif
+#ifndef LOG_SEGMENT_MAX_AGE_S
+#define LOG_SEGMENT_MAX_AGE_S 86400
+#endif
+// 同步模式下 INFO 及以下日志的最长刷新间隔(毫秒)，WARNING 及以上立即刷新
+#define LOG_FLUSH_INTERVAL_MS 1000
+
+// LH08 继电器板串口及应答超时(毫秒)
+#define LH08_SERIAL_PORT "/dev/ttyS6"
+#define LH08_RESPONSE_TIMEOUT_MS 100
+
+// 运动曲线下发频率(Hz)
+#define PROFILE_STREAM_RATE_HZ 500
+// 位置轨迹下发频率(Hz)及单条轨迹最多路点数
+#define TRAJECTORY_STREAM_RATE_HZ 200
+#define TRAJECTORY_MAX_WAYPOINTS 4096
+
+// 实时控制循环：周期(微秒)、SCHED_FIFO 优先级、绑定的 CPU 核心(-1 不绑定)、预触碰的栈大小(字节)
+#define CONTROL_LOOP_PERIOD_US 1000
+#define CONTROL_LOOP_PRIORITY 80
+#define CONTROL_LOOP_CPU -1
+#define CONTROL_LOOP_PREFAULT_STACK (256 * 1024)
+// 唤醒延迟直方图：桶宽(微秒)与桶数；超时直方图桶数（按一次超时跳过的周期数）
+#define CONTROL_LOOP_JITTER_BUCKET_US 10
+#define CONTROL_LOOP_JITTER_BUCKETS 64
+#define CONTROL_LOOP_OVERRUN_BUCKETS 8
+
+// 串级控制器：编码器位数、反馈过期时间(毫秒)，超过该时间未收到状态2响应时输出零转矩
+#define CASCADE_ENCODER_BITS 16
+#define CASCADE_FEEDBACK_STALE_MS 5
+
+// 双履带底盘几何参数：驱动轮半径(m)、履带中心距(m)、电机多圈角度与驱动轮转角之比、电机最大转速(dps)
+#define DRIVE_WHEEL_RADIUS_M 0.05
+#define DRIVE_TRACK_WIDTH_M 0.30
+#define DRIVE_GEAR_RATIO 1.0
+#define DRIVE_MAX_MOTOR_SPEED_DPS 3000.0
+// 左右电机正转对应前进时为 1，反向安装为 -1
+#define DRIVE_LEFT_SIGN 1
+#define DRIVE_RIGHT_SIGN -1
+
+// 定时命令批次：截止时间前开始忙等的提前量(微秒)、保留的最近完成批次数
+#define COMMAND_SCHEDULE_SPIN_US 200
+#define COMMAND_SCHEDULE_HISTORY 32
+
+// 设备句柄表容量，即设备管理器最多同时管理的设备数
+#define DEVICE_MAX_HANDLES 64
+
+// 设备事件总线：队列容量(条)、分发线程检查队列的最长间隔(毫秒)
+#define DEVICE_EVENT_QUEUE_CAPACITY 1024
+#define DEVICE_EVENT_POLL_MS 10
+// 电机上报错误标志时自动下发清除错误命令(0x9B)，故障未消除时不会重复下发
+#define DEVICE_AUTO_CLEAR_ERROR 0
+
+// 堆分配计数：替换全局 operator new/delete 统计分配次数，用于检查控制路径预热后是否访问堆
+// 由 CMake 选项 ENABLE_ALLOC_COUNTER 开启
+#ifndef ALLOC_COUNTER_ENABLED
+#define ALLOC_COUNTER_ENABLED 0
+#endif
@@ -0,0 +1,120 @@
+/**
+ * @file binary_logger.h
+ * @brief 二进制延迟格式化日志头文件
+ * @details 面向高频路径（如 CAN 收发）的日志后端
+ *          - 每个调用点首次执行时注册一次格式描述，之后只记录描述编号
+ *          - 热路径只拷贝时间戳和整型参数到无锁队列，不做任何格式化和内存分配
+ *          - 后台线程批量写入 logs/<name>.bin，由 tools/blog_decode 离线还原为文本日志格式
+ *          - 文件按分段滚动，每个分段都以文件头和已注册的格式描述开头，可独立解码
+ * @note 参数仅支持整型与枚举，格式串中使用 %d %u %x %X %c 等整型转换说明符
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include "logger.h"
+#include "mpmc_queue.h"
+#include "rotating_file.h"
+
+// 文件格式：文件头 BLOG_MAGIC，随后为若干条记录，每条记录以1字节类型开头
+//   BLOG_RECORD_SITE: uint32 编号, uint8 级别, uint16 格式串长度, 格式串
+//   BLOG_RECORD_LOG : uint32 编号, int64 时间(CLOCK_REALTIME 纳秒), uint8 参数个数, 参数(int64 x N)
+// 所有整数均为小端序
+static const char BLOG_MAGIC[8] = {'K', '2', 'B', 'L', 'O', 'G', '1', '\0'};
+enum BlogRecordType : uint8_t {
+    BLOG_RECORD_SITE = 1,
+    BLOG_RECORD_LOG = 2
+};
+
+class BinaryLogger {
+public:
+    static constexpr int MAX_ARGS = 10;
+    static constexpr size_t QUEUE_CAPACITY = 16384;
+    static constexpr uint32_t MAX_SITES = 4096;
+
+    static BinaryLogger& getInstance();
+
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const { return opened.load(std::memory_order_relaxed); }
+    uint64_t getDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
+
+    uint32_t registerSite(LogLevel level, const char* format);
+
+    /**
+     * @brief 记录一条日志（热路径）
+     * @param site registerSite 返回的调用点编号
+     * @param args 整型参数，最多 MAX_ARGS 个
+     */
+    template <typename... Args>
+    void write(uint32_t site, Args... args)
+    {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "二进制日志参数过多");
+        static_assert(((std::is_integral<Args>::value || std::is_enum<Args>::value) && ...), "二进制日志仅支持整型参数");
+
+        Record record;
+        record.site = site;
+        record.nargs = sizeof...(Args);
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        record.time_ns = static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+        int i = 0;
+        ((record.args[i++] = static_cast<int64_t>(args)), ...);
+        if (!queue.tryPush(record)) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct Record {
+        uint32_t site;
+        uint8_t nargs;
+        int64_t time_ns;
+        int64_t args[MAX_ARGS];
+    };
+
+    struct Site {
+        LogLevel level;
+        const char* format;
+    };
+
+    BinaryLogger();
+    ~BinaryLogger();
+    BinaryLogger(const BinaryLogger&) = delete;
+    BinaryLogger& operator=(const BinaryLogger&) = delete;
+
+    void writerLoop();
+    void writeSegmentHeader();
+    void writeSite(uint32_t id);
+    void writeSites();
+    void writeRecord(const Record& record);
+
+    RotatingFile file;
+    MPMCQueue<Record> queue;
+    // 调用点表定长，写线程读取时无需加锁；sitesMutex 只用于串行化注册
+    std::array<Site, MAX_SITES> sites;
+    std::atomic<uint32_t> siteCount;
+    uint32_t sitesWritten; // 已写入当前分段的描述数，仅写线程访问
+    std::mutex sitesMutex;
+
+    std::atomic<bool> opened;
+    std::atomic<bool> writerRunning;
+    std::atomic<uint64_t> droppedCount;
+    std::thread writerThread;
+};
+
+// 二进制日志宏：fmt 必须为字符串字面量，每个调用点只注册一次；
+// 与 LOG_AT 一样受 LOG_COMPILE_LEVEL 和运行时日志级别控制
+#define BLOG(level, fmt, ...) do { \
+    if (LOG_ENABLED(level) && BinaryLogger::getInstance().isOpen()) { \
+        static const uint32_t blog_site_ = BinaryLogger::getInstance().registerSite(level, fmt); \
+        BinaryLogger::getInstance().write(blog_site_, ##__VA_ARGS__); \
+    } \
+} while (0)
@@ -0,0 +1,134 @@
+/**
+ * @file cascade_controller.h
+ * @brief 上位机串级位置/速度控制器头文件
+ * @details 以 0xA1 转矩闭环命令为执行量，在上位机闭合 位置 → 速度 → iqControl 串级环
+ *          - 每个周期取一次电机遥测快照，位置环与速度环使用同一快照中的编码器值与转速
+ *          - 定点运算：位置 0.01°/LSB，速度 1dps/LSB，输出 iq 与协议一致(-2048~2048)，增益为 Q16.16
+ *          - 运行期间不分配内存、不加锁，适合由 ControlLoop 以 1 kHz 调用 tick()
+ *          - 转矩命令的响应为状态2布局，由接收线程写入遥测，作为下一周期的反馈
+ *          - TrackPairController 在同一周期内取左右两侧快照、先算完两侧输出再连续下发两帧
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include "can_device.h"
+#include "motor_units.h"
+#include "seqlock.h"
+
+// 增益与限幅的小数位数
+static constexpr int CASCADE_Q = 16;
+
+// 浮点增益转换为 Q16.16
+constexpr int32_t cascadeGain(double gain)
+{
+    return static_cast<int32_t>(gain * (1 << CASCADE_Q) + (gain >= 0 ? 0.5 : -0.5));
+}
+
+// 单个 PID 环的参数，增益为每周期的 Q16.16 值
+struct PidGains {
+    int32_t kp;
+    int32_t ki;             // 每周期积分增益
+    int32_t kd;             // 每周期微分增益
+    int32_t outputLimit;    // 输出限幅（输出单位）
+    int32_t integralLimit;  // 积分项限幅（输出单位）
+};
+
+// 串级控制参数
+struct CascadeGains {
+    PidGains position; // 位置误差(0.01°) → 速度设定(dps)
+    PidGains velocity; // 速度误差(dps) → iqControl
+};
+
+class CascadeController {
+public:
+    enum class Mode : uint8_t {
+        DISABLED, // 不下发命令
+        VELOCITY, // 只运行速度环
+        POSITION  // 位置环输出作为速度环设定
+    };
+
+    // 单个 PID 环的运行状态
+    struct PidState {
+        int64_t integral;  // 积分项(Q16.16，输出单位)
+        int32_t lastError;
+        bool primed;       // lastError 是否有效，清空后第一个周期微分项为0
+    };
+
+    // 最近一个周期的控制量与统计
+    struct ControlStatus {
+        int64_t position;         // 反馈位置(0.01°)
+        int32_t speed;            // 反馈转速(dps)
+        int32_t velocitySetpoint; // 速度环设定(dps)
+        int16_t iqControl;        // 下发的转矩电流
+        uint64_t ticks;           // 已执行的周期数
+        uint64_t staleTicks;      // 因反馈过期而输出零转矩的周期数
+        uint64_t sendFailures;    // 发送失败次数
+    };
+
+    CascadeController(CANDevice& device, const CascadeGains& gains, int encoderBits);
+
+    void setGains(const CascadeGains& gains);
+    void setMode(Mode mode);
+    void setPositionTarget(units::CentiDegrees position);
+    void setVelocityTarget(units::Dps speed);
+    void reset();
+    void tick();
+
+    // 供多电机控制器使用：由调用方提供快照与时间，compute 只计算不下发，随后用 send 下发
+    bool compute(const MotorTelemetry& telemetry, int64_t now_ns, MotorFrame& frame);
+    bool send(const MotorFrame& frame);
+    CANDevice& device() { return device_; }
+
+    Mode getMode() const { return mode_.load(std::memory_order_relaxed); }
+    ControlStatus getStatus() const { return status_.load(); }
+
+private:
+    static int32_t update(const PidGains& gains, PidState& state, int32_t error);
+    void resetLoops();
+
+    CANDevice& device_;
+    Seqlock<CascadeGains> gains_;
+    int64_t encoderRange_;
+    int64_t staleLimit_ns_;
+
+    std::atomic<Mode> mode_;
+    std::atomic<int64_t> positionTarget_;
+    std::atomic<int32_t> velocityTarget_;
+    std::atomic<bool> resetRequested_;
+
+    // 以下仅控制周期线程访问
+    Mode lastMode_;            // 上一周期的模式，模式改变时清空积分
+    PidState positionState_;
+    PidState velocityState_;
+    bool positionValid_;       // 是否已建立位置基准
+    uint16_t lastEncoder_;
+    int64_t encoderCount_;     // 展开后的累计编码器计数
+    int64_t positionOffset_;   // 位置基准(0.01°)
+    int64_t lastFeedback_ns_;  // 最近一次使用的状态2时间戳
+    uint64_t ticks_;
+    uint64_t staleTicks_;
+    uint64_t sendFailures_;
+
+    Seqlock<ControlStatus> status_;
+};
+
+/**
+ * @brief 左右履带串级控制器
+ * @details 每个周期先读取两侧电机的遥测快照，用同一时间戳分别运行两侧的串级环，
+ *          两侧输出都算完后再连续下发两帧转矩命令，两侧命令之间不夹杂计算
+ */
+class TrackPairController {
+public:
+    TrackPairController(CANDevice& left, CANDevice& right, const CascadeGains& gains, int encoderBits);
+
+    void tick();
+
+    CascadeController& left() { return left_; }
+    CascadeController& right() { return right_; }
+
+private:
+    CascadeController left_;
+    CascadeController right_;
+};
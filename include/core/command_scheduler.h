@@ -0,0 +1,93 @@
+/**
+ * @file command_scheduler.h
+ * @brief 定时命令批次调度器头文件
+ * @details 将一组命令预先构造成 CAN 帧，在指定的单调时钟时刻由调度线程连续发出，
+ *          用于松开抱闸与启动两侧电机等需要多设备同步的动作
+ *          - 调度线程在截止时间前 COMMAND_SCHEDULE_SPIN_US 醒来，忙等到截止时刻后连续写出全部帧
+ *          - 每个批次报告首帧相对截止时间的延迟以及首帧与末帧之间的偏差（skew）
+ *          - 预约批次视为控制帧，不经过总线负载调节器
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "can_device.h"
+
+// 预构造的命令批次
+class CommandBatch {
+public:
+    bool add(CANDevice& device, uint8_t command, const uint8_t* data = nullptr);
+    void clear() { frames_.clear(); }
+    size_t size() const { return frames_.size(); }
+    bool empty() const { return frames_.empty(); }
+
+private:
+    friend class CommandScheduler;
+
+    struct Entry {
+        CANInterface* interface;
+        struct can_frame frame;
+    };
+    std::vector<Entry> frames_;
+};
+
+class CommandScheduler {
+public:
+    // 批次执行结果，时间均为 steady_clock 纳秒
+    struct BatchResult {
+        uint64_t id;
+        int64_t deadline_ns;  // 计划发出时刻
+        int64_t first_ns;     // 首帧提交时刻
+        int64_t last_ns;      // 末帧提交时刻
+        int64_t lateness_ns;  // 首帧相对计划时刻的延迟
+        int64_t skew_ns;      // 首帧与末帧提交时刻之差
+        size_t sent;          // 发送成功的帧数
+        size_t count;         // 批次帧数
+        bool cancelled;       // 在截止时间前被取消
+    };
+    using Callback = std::function<void(const BatchResult&)>;
+
+    explicit CommandScheduler(int priority = 0);
+    ~CommandScheduler();
+
+    bool start();
+    void stop();
+
+    uint64_t schedule(const CommandBatch& batch, int64_t deadline_ns, Callback callback = nullptr);
+    uint64_t scheduleIn(const CommandBatch& batch, uint32_t delay_ms, Callback callback = nullptr);
+    bool cancel(uint64_t id);
+    bool wait(uint64_t id, BatchResult& result, uint32_t timeout_ms);
+
+    static int64_t now();
+
+private:
+    struct Pending {
+        uint64_t id;
+        CommandBatch batch;
+        Callback callback;
+    };
+
+    void run();
+    BatchResult emit(const Pending& pending, int64_t deadline_ns);
+    void complete(const BatchResult& result, const Callback& callback);
+
+    int priority_; // 调度线程 SCHED_FIFO 优先级，0 表示普通调度
+
+    std::mutex mutex_;
+    std::condition_variable cv_;       // 新批次或停止时唤醒调度线程
+    std::condition_variable doneCv_;   // 批次完成时唤醒 wait()
+    std::multimap<int64_t, Pending> pending_; // 按截止时间排序
+    std::deque<BatchResult> results_;  // 最近完成的批次，最多 COMMAND_SCHEDULE_HISTORY 个
+    uint64_t nextId_;
+
+    std::atomic<bool> running_;
+    std::thread thread_;
+};
@@ -0,0 +1,87 @@
+/**
+ * @file control_loop.h
+ * @brief 实时周期控制循环执行器头文件
+ * @details 在一个 SCHED_FIFO 线程中按 clock_nanosleep(TIMER_ABSTIME) 的绝对截止时间周期执行已注册的任务
+ *          - 可选绑定 CPU 核心、mlockall 锁定内存并预触碰栈，避免运行中缺页
+ *          - 记录每个周期的唤醒延迟（抖动）直方图与超时直方图
+ *          - 任务按周期分频执行，任务表在 start() 后不再改变，运行期间不分配内存
+ *          - 无实时权限时（未以 root 运行或无 CAP_SYS_NICE）退化为普通调度并记录警告
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "global_config.h"
+
+class ControlLoop {
+public:
+    // 周期任务，参数为本周期的计划唤醒时间(CLOCK_MONOTONIC 纳秒)
+    using Task = std::function<void(int64_t deadline_ns)>;
+
+    // 实时参数
+    struct Options {
+        int64_t period_ns;   // 周期(纳秒)
+        int priority;        // SCHED_FIFO 优先级(1~99)，0 表示不切换调度策略
+        int cpu;             // 绑定的 CPU 核心，-1 表示不绑定
+        bool lockMemory;     // 是否 mlockall 并预触碰栈
+    };
+
+    // 周期统计
+    struct LoopStats {
+        uint64_t cycles;          // 已执行的周期数
+        uint64_t overruns;        // 任务执行超过一个周期的次数
+        uint64_t missedPeriods;   // 因超时被跳过的周期数
+        int64_t maxLatency_ns;    // 最大唤醒延迟
+        int64_t meanLatency_ns;   // 平均唤醒延迟
+        int64_t maxExecution_ns;  // 单周期任务执行最长时间
+        bool realtime;            // 是否成功切换到 SCHED_FIFO
+        std::array<uint64_t, CONTROL_LOOP_JITTER_BUCKETS> latencyHistogram; // 第i桶：[i, i+1) * CONTROL_LOOP_JITTER_BUCKET_US 微秒，末桶含更大值
+        std::array<uint64_t, CONTROL_LOOP_OVERRUN_BUCKETS> overrunHistogram; // 第i桶：一次超时跳过 i+1 个周期，末桶含更多
+    };
+
+    explicit ControlLoop(const Options& options);
+    ~ControlLoop();
+
+    bool addTask(const std::string& name, Task task, uint32_t divider = 1);
+    bool start();
+    void stop();
+
+    bool isRunning() const { return running_; }
+    LoopStats getStats() const;
+    void resetStats();
+    std::string formatStats() const;
+
+private:
+    struct TaskEntry {
+        std::string name;
+        Task task;
+        uint32_t divider; // 每 divider 个周期执行一次
+    };
+
+    void run();
+    void setupThread();
+    void recordLatency(int64_t latency_ns);
+    void recordOverrun(uint64_t missed);
+
+    Options options_;
+    std::vector<TaskEntry> tasks_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+
+    // 统计：仅循环线程写入，读取方按 relaxed 取快照
+    std::atomic<uint64_t> cycles_;
+    std::atomic<uint64_t> overruns_;
+    std::atomic<uint64_t> missedPeriods_;
+    std::atomic<int64_t> maxLatency_ns_;
+    std::atomic<int64_t> sumLatency_ns_;
+    std::atomic<int64_t> maxExecution_ns_;
+    std::atomic<bool> realtime_;
+    std::array<std::atomic<uint64_t>, CONTROL_LOOP_JITTER_BUCKETS> latencyHistogram_;
+    std::array<std::atomic<uint64_t>, CONTROL_LOOP_OVERRUN_BUCKETS> overrunHistogram_;
+};
@@ -0,0 +1,105 @@
+/**
+ * @file device_event_bus.h
+ * @brief 设备事件总线头文件
+ * @details 设备状态变化、命令响应超时和电机错误标志变化以事件形式投递到无锁队列，
+ *          由总线自己的分发线程按订阅过滤条件回调订阅者
+ *          - 投递方（心跳线程、CAN 接收线程、命令线程）只做一次入队，不等待订阅者，队列满时丢弃并计数
+ *          - 订阅者按设备ID和事件类型过滤，回调在分发线程中依次执行，可以做阻塞操作（如下发清错命令）
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "device_protocol.h"
+#include "mpmc_queue.h"
+
+// 事件类型，按位组合用作过滤掩码
+enum class DeviceEventType : uint32_t {
+    STATUS_CHANGED = 0x01, // 设备状态变化
+    TIMEOUT = 0x02,        // 命令等待响应超时
+    ERROR_FLAGS = 0x04     // 电机错误标志变化（状态1 errorState）
+};
+
+constexpr uint32_t DEVICE_EVENT_ALL = 0x07;
+
+constexpr uint32_t eventMask(DeviceEventType type) { return static_cast<uint32_t>(type); }
+
+// 设备事件
+struct DeviceEvent {
+    DeviceEventType type;
+    std::string deviceId;
+    DeviceStatus status;        // STATUS_CHANGED：新状态
+    uint8_t command;            // TIMEOUT：等待的响应命令
+    uint8_t errorState;         // ERROR_FLAGS：新的错误标志
+    uint8_t previousErrorState; // ERROR_FLAGS：变化前的错误标志
+    int64_t timestamp_ns;       // 投递时间(steady_clock)
+};
+
+// 订阅过滤条件
+struct DeviceEventFilter {
+    std::string deviceId;              // 为空表示所有设备
+    uint32_t typeMask = DEVICE_EVENT_ALL;
+
+    bool matches(const DeviceEvent& event) const {
+        return (typeMask & eventMask(event.type)) && (deviceId.empty() || deviceId == event.deviceId);
+    }
+};
+
+class DeviceEventBus {
+public:
+    using Handler = std::function<void(const DeviceEvent&)>;
+
+    static DeviceEventBus& getInstance();
+
+    void start();
+    void stop();
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    bool post(DeviceEvent event);
+    bool postStatus(const std::string& deviceId, DeviceStatus status);
+    bool postTimeout(const std::string& deviceId, uint8_t command);
+    bool postErrorFlags(const std::string& deviceId, uint8_t errorState, uint8_t previousErrorState);
+
+    uint64_t subscribe(const DeviceEventFilter& filter, Handler handler);
+    void unsubscribe(uint64_t id);
+
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t getDeliveredCount() const { return delivered_.load(std::memory_order_relaxed); }
+
+private:
+    struct Subscriber {
+        uint64_t id;
+        DeviceEventFilter filter;
+        std::shared_ptr<Handler> handler;
+    };
+
+    DeviceEventBus();
+    ~DeviceEventBus();
+    DeviceEventBus(const DeviceEventBus&) = delete;
+    DeviceEventBus& operator=(const DeviceEventBus&) = delete;
+
+    void dispatchLoop();
+    void dispatch(const DeviceEvent& event);
+
+    MPMCQueue<DeviceEvent> queue_;
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCv_;
+
+    std::mutex subscribersMutex_;
+    std::vector<Subscriber> subscribers_;
+    std::mutex dispatchMutex_; // 分发期间持有，保证 unsubscribe 返回后回调不再执行
+    uint64_t nextId_;
+
+    std::atomic<bool> running_;
+    std::thread thread_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> delivered_;
+};
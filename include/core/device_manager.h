@@ -1,24 +1,231 @@
 #pragma once
+#include <array>
 #include <unordered_map>
 #include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
 #include <vector>
 #include "can_device.h"
 #include "rs232_device.h"
+#include "global_config.h"
+#include "device_event_bus.h"
+
+/**
+ * @brief 编译期设备注册表
+ * @details 内置设备类型在编译期列出，设备对象直接存放在 variant 中，
+ *          命令经 std::visit 分发到具体类型（内置类型均为 final，调用不经虚表）；
+ *          未列出的协议仍通过 DeviceFactory 创建，以 unique_ptr<Device> 形式存放，走虚接口
+ */
+template <typename... Builtins>
+struct DeviceRegistry {
+    using Slot = std::variant<Builtins..., std::unique_ptr<Device>>;
+
+    template <typename T>
+    static constexpr bool contains = (std::is_same<T, Builtins>::value || ...);
+};
+
+using BuiltinDevices = DeviceRegistry<CANDevice, RS232Device>;
+using DeviceSlot = BuiltinDevices::Slot;
+
+/**
+ * @brief 对设备槽调用 f(具体设备&)，插件设备以 Device& 传入
+ */
+template <typename F>
+decltype(auto) visitDevice(DeviceSlot& slot, F&& f) {
+    return std::visit([&f](auto& device) -> decltype(auto) {
+        if constexpr (std::is_same<std::decay_t<decltype(device)>, std::unique_ptr<Device>>::value) {
+            return f(*device);
+        } else {
+            return f(device);
+        }
+    }, slot);
+}
+
+template <typename F>
+decltype(auto) visitDevice(const DeviceSlot& slot, F&& f) {
+    return std::visit([&f](const auto& device) -> decltype(auto) {
+        if constexpr (std::is_same<std::decay_t<decltype(device)>, std::unique_ptr<Device>>::value) {
+            return f(static_cast<const Device&>(*device));
+        } else {
+            return f(device);
+        }
+    }, slot);
+}
+
+/**
+ * @brief 设备句柄
+ * @details 低16位为句柄表下标+1，高16位为该表项的代数；设备移除后代数递增，旧句柄随即失效。
+ *          控制路径先用 getHandle() 解析一次 ID，之后按句柄访问，不再构造字符串或做哈希查找
+ */
+struct DeviceHandle {
+    uint32_t value = 0;
+
+    bool valid() const { return value != 0; }
+    friend bool operator==(DeviceHandle a, DeviceHandle b) { return a.value == b.value; }
+    friend bool operator!=(DeviceHandle a, DeviceHandle b) { return a.value != b.value; }
+};
 
 class DeviceManager {
 public:
     DeviceManager();
+    ~DeviceManager();
     bool addDevice(const std::string& protocol, const std::string& id, Interface& interface);
+    template <typename T, typename I>
+    bool addDevice(const std::string& id, I& interface);
     bool removeDevice(const std::string& id);
     bool connectDevice(const std::string& id);
     bool disconnectDevice(const std::string& id);
     bool sendCommand(const std::string& id, uint8_t command, const uint8_t *data);
     std::vector<std::string> listDevices() const;
     DeviceStatus getDeviceStatus(const std::string& id) const;
+    Device* getDevice(const std::string& id);
+    template <typename T>
+    T* getDeviceAs(const std::string& id);
+
+    // 按句柄访问，稳态下不分配内存
+    DeviceHandle getHandle(const std::string& id) const;
+    bool sendCommand(DeviceHandle handle, uint8_t command, const uint8_t *data);
+    Device* getDevice(DeviceHandle handle);
+    template <typename T, typename F>
+    bool withDevice(DeviceHandle handle, F&& f);
+
+    void setAutoClearError(bool enable);
 
 private:
+    template <typename T>
+    DeviceSlot* emplaceDevice(const std::string& id);
+    template <typename... Builtins>
+    DeviceSlot* emplaceBuiltin(const std::string& protocol, const std::string& id, DeviceRegistry<Builtins...>);
+    bool validateId(const std::string& id) const;
+    void attachStatusCallback(Device& device);
+    bool bindHandle(DeviceSlot* slot);
+    void releaseHandle(const DeviceSlot* slot);
+    DeviceSlot* lookup(DeviceHandle handle) const;
     void handleDeviceStatusChange(const std::string& id, DeviceStatus status);
+    void logDeviceEvent(const DeviceEvent& event);
+    void clearMotorError(const DeviceEvent& event);
+
+    struct HandleEntry {
+        DeviceSlot* slot = nullptr;
+        uint16_t generation = 1;
+    };
 
-    std::unordered_map<std::string, std::unique_ptr<Device>> devices;
+    // 节点式容器：设备对象原地构造在节点中，地址在增删其它设备时保持不变
+    std::unordered_map<std::string, DeviceSlot> devices;
+    std::array<HandleEntry, DEVICE_MAX_HANDLES> handles{};
     mutable std::mutex devicesMutex;
+
+    uint64_t logSubscription = 0;
+    std::atomic<uint64_t> clearErrorSubscription{0};
 };
+
+/**
+ * @brief 原地构造内置设备
+ * @return DeviceSlot* 新设备所在槽，ID 已存在返回 nullptr
+ * @note 调用者需持有 devicesMutex
+ */
+template <typename T>
+DeviceSlot* DeviceManager::emplaceDevice(const std::string& id) {
+    static_assert(BuiltinDevices::contains<T>, "设备类型未在 BuiltinDevices 中注册");
+    auto result = devices.emplace(std::piecewise_construct,
+                                  std::forward_as_tuple(id),
+                                  std::forward_as_tuple(std::in_place_type<T>, id));
+    return result.second ? &result.first->second : nullptr;
+}
+
+/**
+ * @brief 按协议名匹配内置设备类型并原地构造
+ * @return DeviceSlot* 新设备所在槽，协议不是内置类型返回 nullptr
+ * @note 调用者需持有 devicesMutex 并已确认 ID 不存在
+ */
+template <typename... Builtins>
+DeviceSlot* DeviceManager::emplaceBuiltin(const std::string& protocol, const std::string& id, DeviceRegistry<Builtins...>) {
+    DeviceSlot* slot = nullptr;
+    (void)((protocol == Builtins::PROTOCOL && (slot = emplaceDevice<Builtins>(id), true)) || ...);
+    return slot;
+}
+
+/**
+ * @brief 以具体类型添加内置设备
+ * @details 类型与接口在编译期确定，不经工厂查找，也不做接口类型的运行期检查
+ * @tparam T 内置设备类型
+ * @tparam I 设备接口类型（如 CANInterface、RS232Interface）
+ * @param id 设备唯一标识符
+ * @param interface 设备接口引用
+ * @return bool 添加成功返回true，失败返回false
+ */
+template <typename T, typename I>
+bool DeviceManager::addDevice(const std::string& id, I& interface) {
+    if (!validateId(id)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(devicesMutex);
+    DeviceSlot* slot = emplaceDevice<T>(id);
+    if (!slot) {
+        LOG_WARNING("设备id [" + id + "] 已存在");
+        return false;
+    }
+    if (!bindHandle(slot)) {
+        devices.erase(id);
+        return false;
+    }
+    T& device = std::get<T>(*slot);
+    attachStatusCallback(device);
+    device.setInterface(interface);
+    LOG_INFO("已添加设备: [" + id + "] (" + T::PROTOCOL + ")");
+    return true;
+}
+
+/**
+ * @brief 以具体类型获取设备
+ * @details 内置类型直接从 variant 取出；插件类型经 dynamic_cast 转换
+ * @return T* 设备指针，设备不存在或类型不符返回nullptr
+ * @note 返回的指针在设备被移除后失效
+ */
+template <typename T>
+T* DeviceManager::getDeviceAs(const std::string& id) {
+    std::lock_guard<std::mutex> lock(devicesMutex);
+    auto it = devices.find(id);
+    if (it == devices.end()) {
+        return nullptr;
+    }
+    if constexpr (BuiltinDevices::contains<T>) {
+        return std::get_if<T>(&it->second);
+    } else {
+        auto* plugin = std::get_if<std::unique_ptr<Device>>(&it->second);
+        return plugin ? dynamic_cast<T*>(plugin->get()) : nullptr;
+    }
+}
+
+/**
+ * @brief 按句柄以具体类型访问设备
+ * @details f(T&) 在 devicesMutex 下执行，期间设备不会被移除；适合不等待响应的短操作，
+ *          长期保存设备的模块应保存句柄而不是设备指针
+ * @tparam T 设备类型
+ * @param handle 设备句柄
+ * @param f 回调
+ * @return bool 句柄有效且类型相符、已调用 f 返回true
+ */
+template <typename T, typename F>
+bool DeviceManager::withDevice(DeviceHandle handle, F&& f) {
+    std::lock_guard<std::mutex> lock(devicesMutex);
+    DeviceSlot* slot = lookup(handle);
+    if (!slot) {
+        return false;
+    }
+    T* device = nullptr;
+    if constexpr (BuiltinDevices::contains<T>) {
+        device = std::get_if<T>(slot);
+    } else {
+        auto* plugin = std::get_if<std::unique_ptr<Device>>(slot);
+        device = plugin ? dynamic_cast<T*>(plugin->get()) : nullptr;
+    }
+    if (!device) {
+        return false;
+    }
+    f(*device);
+    return true;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file diff_drive.h
+ * @brief 双履带差速运动学与里程计头文件
+ * @details 左右两台 CAN 电机组成差速底盘
+ *          - 线速度/角速度命令换算为左右电机转速，超出电机最大转速时两侧按同一比例缩放以保持转弯半径，
+ *            两帧 0xA2 连续发出，不等待响应
+ *          - 里程计增量消费两侧的多圈位置遥测：两侧都有新读数时才积分一次，
+ *            先到的一侧其增量保留到另一侧读数到达；位姿时间戳取所用读数中最新的一个
+ *          - 多圈位置由调用方定期读取（例如 PollScheduler 轮询 MOTOR_GET_MULTI_POSITION）
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <cstdint>
+#include "can_device.h"
+#include "seqlock.h"
+
+// 底盘几何参数
+struct DriveGeometry {
+    double wheelRadius;    // 驱动轮（链轮）半径(m)
+    double trackWidth;     // 左右履带中心距(m)
+    double gearRatio;      // 电机多圈位置角度 / 驱动轮转角
+    int leftSign;          // 左电机正转对应前进为 +1，否则为 -1
+    int rightSign;         // 右电机正转对应前进为 +1，否则为 -1
+    double maxMotorSpeed;  // 电机最大转速(dps)
+};
+
+// 里程计位姿
+struct OdometryPose {
+    double x;             // 位置(m)，起点为原点，初始朝向为 x 轴
+    double y;
+    double theta;         // 航向(rad)，逆时针为正，不做归一化
+    double distance;      // 中心累计行驶距离(m)，后退为负
+    int64_t timestamp_ns; // 所用多圈位置读数中最新的时间戳(steady_clock)，尚未积分时为0
+};
+
+class DiffDrive {
+public:
+    DiffDrive(CANDevice& left, CANDevice& right, const DriveGeometry& geometry = defaultGeometry());
+
+    static DriveGeometry defaultGeometry();
+
+    bool drive(double linear, double angular);
+    bool stop();
+    bool update();
+    void resetPose();
+
+    OdometryPose getPose() const { return pose_.load(); }
+    const DriveGeometry& getGeometry() const { return geometry_; }
+
+private:
+    // 单侧里程计状态
+    struct Track {
+        CANDevice* device;
+        int sign;
+        bool valid;           // 是否已取得基准读数
+        int64_t position;     // 上次积分时的多圈位置(0.01°)
+        int64_t latest;       // 最近一次读数，尚未积分的行程为 latest - position
+        int64_t timestamp_ns; // 最近一次读数的时间戳
+        bool fresh;           // 上次积分之后是否有新读数
+    };
+
+    void poll(Track& track);
+    bool sendSpeed(CANDevice& device, double dps);
+
+    DriveGeometry geometry_;
+    double metersPerCentiDegree_; // 多圈位置 1 LSB 对应的履带行程(m)
+    Track left_;
+    Track right_;
+    OdometryPose state_;          // 仅 update() 线程访问
+    Seqlock<OdometryPose> pose_;  // 供其它线程无锁读取
+};
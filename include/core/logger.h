@@ -6,6 +6,12 @@
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "mpmc_queue.h"
+#include "rotating_file.h"
+#include "global_config.h"
 
 enum LogLevel {
     DEBUG,
@@ -15,28 +21,72 @@ enum LogLevel {
     CRITICAL
 };
 
+// 异步模式下队列满时的处理策略
+enum class LogOverflowPolicy {
+    DROP,  // 丢弃新日志并计数，调用线程不等待
+    BLOCK  // 等待后台线程腾出空间
+};
+
 class Logger {
 public:
     static Logger& getInstance();
     void log(LogLevel level, const std::string& message);
     void setLogFile(const std::string& filename);
+    void setRotation(size_t segmentSize, int segmentCount, std::chrono::seconds maxAge);
     void setConsoleOutput(bool enabled);
     bool isConsoleOutputEnabled() const;
+    void setLevel(LogLevel level) { minLevel.store(level, std::memory_order_relaxed); }
+    LogLevel getLevel() const { return minLevel.load(std::memory_order_relaxed); }
+    bool isEnabled(LogLevel level) const { return level >= minLevel.load(std::memory_order_relaxed); }
+
+    // 异步模式
+    void setAsync(bool enabled, size_t capacity = 8192, LogOverflowPolicy policy = LogOverflowPolicy::DROP);
+    bool isAsync() const { return asyncEnabled.load(std::memory_order_acquire); }
+    void flush();
+    uint64_t getDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
 
 private:
+    struct LogRecord {
+        LogLevel level;
+        std::chrono::system_clock::time_point time;
+        std::string message;
+    };
+
     Logger();
     ~Logger();
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
-    std::ofstream logFile;
+    void writeRecord(const LogRecord& record);
+    void writerLoop();
+    void stopWriter();
+
+    RotatingFile logFile;
+    std::string logFileName;
+    size_t segmentSize;
+    int segmentCount;
+    std::chrono::seconds segmentMaxAge;
+    std::chrono::steady_clock::time_point lastFlush;
     std::mutex logMutex;
     bool consoleOutputEnabled;
+    std::atomic<LogLevel> minLevel; // 运行时最低输出级别
+
+    std::unique_ptr<MPMCQueue<LogRecord>> queue;
+    std::atomic<bool> asyncEnabled;
+    std::atomic<bool> writerRunning;
+    std::atomic<uint64_t> droppedCount;
+    std::atomic<uint64_t> pendingCount; // 已入队但尚未写出的条数
+    LogOverflowPolicy overflowPolicy;
+    std::thread writerThread;
 };
 
 // 日志宏定义
-#define LOG_DEBUG(msg) Logger::getInstance().log(DEBUG, msg)
-#define LOG_INFO(msg) Logger::getInstance().log(INFO, msg)
-#define LOG_WARNING(msg) Logger::getInstance().log(WARNING, msg)
-#define LOG_ERROR(msg) Logger::getInstance().log(ERROR, msg)
-#define LOG_CRITICAL(msg) Logger::getInstance().log(CRITICAL, msg)
\ No newline at end of file
+// 级别低于 LOG_COMPILE_LEVEL 的日志在编译期被消除；低于运行时级别的日志不会求值 msg 参数
+#define LOG_ENABLED(level) ((level) >= LOG_COMPILE_LEVEL && Logger::getInstance().isEnabled(level))
+#define LOG_AT(level, msg) do { if (LOG_ENABLED(level)) Logger::getInstance().log(level, msg); } while (0)
+
+#define LOG_DEBUG(msg) LOG_AT(DEBUG, msg)
+#define LOG_INFO(msg) LOG_AT(INFO, msg)
+#define LOG_WARNING(msg) LOG_AT(WARNING, msg)
+#define LOG_ERROR(msg) LOG_AT(ERROR, msg)
+#define LOG_CRITICAL(msg) LOG_AT(CRITICAL, msg)
\ No newline at end of file
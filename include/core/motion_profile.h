@@ -0,0 +1,54 @@
+/**
+ * @file motion_profile.h
+ * @brief 加加速度受限的运动曲线生成器头文件
+ * @details 将目标速度或目标位置转换为平滑的设定值序列（S 曲线）
+ *          - 速度、加速度、加加速度均受限，每个周期增量计算一次，不分配内存
+ *          - 目标可在运行中随时修改，曲线从当前状态平滑过渡
+ *          - 单位由使用者决定：速度流中为 dps / dps/s / dps/s²，转矩流中“速度”即转矩值
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+
+// 曲线约束
+struct ProfileLimits {
+    double maxVelocity;
+    double maxAcceleration;
+    double maxJerk;
+};
+
+// 曲线状态
+struct ProfileState {
+    double position;
+    double velocity;
+    double acceleration;
+};
+
+class MotionProfile {
+public:
+    enum class Mode {
+        VELOCITY, // 跟踪目标速度
+        POSITION  // 到达目标位置并停止
+    };
+
+    explicit MotionProfile(const ProfileLimits& limits);
+
+    void setLimits(const ProfileLimits& limits);
+    void reset(const ProfileState& state);
+    void setVelocityTarget(double velocity);
+    void setPositionTarget(double position);
+
+    const ProfileState& step(double dt);
+    const ProfileState& state() const { return state_; }
+    Mode mode() const { return mode_; }
+    bool done() const;
+
+private:
+    void trackVelocity(double target, double dt);
+    double stoppingDistance(double v, double a) const;
+
+    ProfileLimits limits_;
+    ProfileState state_;
+    Mode mode_;
+    double target_;
+};
@@ -0,0 +1,97 @@
+/**
+ * @file poll_scheduler.h
+ * @brief 遥测轮询调度器头文件
+ * @details 按 (设备, 命令) 设定目标轮询频率，在总线带宽预算内生成交错的轮询计划
+ *          - 需求超出预算时按比例降低所有轮询频率
+ *          - 按最早截止时间优先发出请求，不等待响应即可继续发送下一条，
+ *            使多个设备的响应在总线上重叠
+ *          - 同一 (设备, 命令) 同一时刻最多只有一个未完成请求
+ *          - 轮询项按设备句柄保存，设备被 DeviceManager 移除后句柄失效，对应轮询项随之删除；
+ *            访问设备与发送请求时不持有调度器的锁
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "device_manager.h"
+
+class PollScheduler {
+public:
+    // 单个轮询项的统计信息
+    struct PollStats {
+        std::string deviceId;
+        uint8_t command;
+        double targetRate;    // 目标频率(Hz)
+        double scheduledRate; // 预算约束后的实际计划频率(Hz)
+        uint64_t sent;        // 已发送请求数
+        uint64_t answered;    // 已收到响应数
+        uint64_t missed;      // 超时或被限流的次数
+    };
+
+    PollScheduler(DeviceManager& manager, CANInterface& can, double busBudget = 0.5);
+    ~PollScheduler();
+
+    bool addPoll(DeviceHandle device, MOTOR_COMMAND command, double rateHz);
+    bool removePoll(DeviceHandle device, MOTOR_COMMAND command);
+    void setBusBudget(double fraction);
+    void setPipelineDepth(int depth);
+    void setReplyTimeout(uint32_t timeout_ms);
+
+    bool start();
+    void stop();
+
+    double getScale() const;
+    std::vector<PollStats> getStats() const;
+
+private:
+    struct PollEntry {
+        DeviceHandle device;
+        std::string deviceId;
+        int node;
+        uint8_t command;
+        double targetRate;
+        int64_t period_ns;
+        int64_t next_due_ns;
+        int64_t sent_ns;
+        uint32_t reply_seq;
+        bool inflight;
+        uint64_t sent;
+        uint64_t answered;
+        uint64_t missed;
+        bool removed;       // 设备已被移除，待删除
+    };
+
+    // 未完成请求在解锁期间读到的响应序号
+    struct ReplyCheck {
+        DeviceHandle device;
+        uint8_t command;
+        uint32_t reply_seq;
+        bool present;
+    };
+
+    void replan();
+    void run();
+    int64_t collectReplies(std::unique_lock<std::mutex>& lock, int64_t now);
+    PollEntry* findEntry(DeviceHandle device, uint8_t command);
+    void pruneRemoved();
+
+    DeviceManager& manager_;
+    CANInterface& can_;
+    std::vector<PollEntry> entries_;
+    std::vector<ReplyCheck> checks_; // 仅调度线程使用，容量复用
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+
+    double busBudget_;     // 轮询可占用的总线比例(0.0~1.0)
+    double scale_;         // 预算约束后的频率缩放系数
+    int pipelineDepth_;    // 全局最多未完成请求数
+    int64_t replyTimeout_ns_;
+
+    std::atomic<bool> running_;
+    std::thread thread_;
+};
@@ -0,0 +1,61 @@
+/**
+ * @file profile_streamer.h
+ * @brief 运动曲线定频下发器头文件
+ * @details 在独立线程中按固定频率推进 MotionProfile，并将每个周期的设定值下发给电机
+ *          - 速度流：以 0xA2 速度闭环命令下发曲线速度(dps)，支持目标速度与相对位置两种目标
+ *          - 转矩流：以 0xA1 转矩闭环命令下发曲线值（即 iq 设定值，-2048~2048）
+ *          - 自身以一个普通调度的 ControlLoop 任务定频运行，不等待电机响应，运行期间不分配内存
+ *          - 也可不调用 start()，由外部 ControlLoop 以相同频率调用 tick()
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include "can_device.h"
+#include "control_loop.h"
+#include "motion_profile.h"
+
+class ProfileStreamer {
+public:
+    // 下发统计
+    struct StreamStats {
+        uint64_t ticks;        // 已执行的周期数
+        uint64_t overruns;     // 落后超过一个周期而跳过的周期数
+        uint64_t sendFailures; // 发送失败或被限流的次数
+    };
+
+    ProfileStreamer(CANDevice& device, MOTOR_COMMAND command, const ProfileLimits& limits, double rateHz);
+    ~ProfileStreamer();
+
+    bool start();
+    void stop();
+    bool tick();
+
+    void setLimits(const ProfileLimits& limits);
+    void setTarget(double target);
+    bool setPositionTarget(double delta);
+    void reset(const ProfileState& state);
+
+    ProfileState getState() const;
+    bool isDone() const;
+    StreamStats getStats() const;
+
+private:
+    bool supported() const;
+    void step();
+    bool send(double value);
+
+    CANDevice& device_;
+    MOTOR_COMMAND command_;
+    MotionProfile profile_;
+    int64_t period_ns_;
+    double dt_;
+
+    mutable std::mutex mutex_; // 保护 profile_，仅在更新目标和推进一个周期时短暂持有
+    ControlLoop loop_;
+
+    std::atomic<uint64_t> ticks_;
+    std::atomic<uint64_t> sendFailures_;
+};
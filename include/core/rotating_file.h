@@ -0,0 +1,53 @@
+/**
+ * @file rotating_file.h
+ * @brief 按大小/时间滚动的日志文件头文件
+ * @details 日志文件由固定数量的分段组成，总占用空间有上限
+ *          - 当前分段为 <name>.<ext>，历史分段为 <name>.1.<ext> ~ <name>.<N-1>.<ext>，编号越大越旧
+ *          - 新分段打开时用 fallocate 预分配空间，减少写入过程中的块分配和碎片
+ *          - 写入先进入用户态大缓冲区，缓冲区满或显式 flush 时才产生一次 write 系统调用
+ *          - 分段写满或超过最长时间后滚动，最旧的分段被删除
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+class RotatingFile {
+public:
+    RotatingFile();
+    ~RotatingFile();
+    RotatingFile(const RotatingFile&) = delete;
+    RotatingFile& operator=(const RotatingFile&) = delete;
+
+    bool open(const std::string& path, size_t segmentSize, int segmentCount,
+              std::chrono::seconds maxAge = std::chrono::seconds(0), size_t bufferSize = 64 * 1024);
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+
+    void write(const char* data, size_t length);
+    void flush();
+
+    // 新分段打开后回调，用于写入文件头等每个分段都需要的内容
+    void setSegmentCallback(std::function<void()> callback) { segmentCallback_ = std::move(callback); }
+
+private:
+    bool openSegment();
+    void rotate();
+    std::string segmentPath(int index) const;
+
+    int fd_;
+    std::string path_;
+    size_t segmentSize_;
+    int segmentCount_;
+    std::chrono::seconds maxAge_;
+    std::chrono::steady_clock::time_point segmentOpened_;
+    size_t written_; // 当前分段已写入（含缓冲区中待写）的字节数
+
+    std::vector<char> buffer_;
+    size_t used_;
+    std::function<void()> segmentCallback_;
+};
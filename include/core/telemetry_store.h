@@ -0,0 +1,67 @@
+/**
+ * @file telemetry_store.h
+ * @brief 全车遥测数据表头文件
+ * @details 以结构数组（SoA）形式集中存放所有电机的遥测数据，按设备句柄索引
+ *          - 句柄即 DeviceManager 句柄表的下标，由 DeviceManager 在添加设备时分配给 CANDevice，
+ *            不同 CAN 接口上电机ID相同的电机各占一行
+ *          - 由各 CANDevice 的解析函数写入
+ *          - 全车聚合查询（最高温度、母线总电流、最低电压等）只需对连续数组做几次遍历，
+ *            编译器可自动向量化，适合在每个控制周期调用
+ *          - 无效槽位填充哨兵值（温度取最小值、电压取最大值、电流取0），聚合时无需分支
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <cstdint>
+#include "global_config.h"
+#include "seqlock.h"
+
+class TelemetryStore {
+public:
+    static constexpr int MAX_DEVICES = DEVICE_MAX_HANDLES; // 句柄 = 设备句柄表下标
+    static_assert(MAX_DEVICES <= 64, "设备位图为64位");
+
+    static constexpr int16_t INVALID_TEMPERATURE = INT16_MIN;
+    static constexpr uint16_t INVALID_VOLTAGE = UINT16_MAX;
+
+    // 遥测数据表，每个数组按句柄索引
+    struct Table {
+        alignas(32) int16_t temperature[MAX_DEVICES]; // 电机温度(1℃/LSB)
+        alignas(32) uint16_t voltage[MAX_DEVICES];    // 母线电压(0.01V/LSB)
+        alignas(32) uint16_t current[MAX_DEVICES];    // 母线电流(0.01A/LSB)
+        alignas(32) int16_t iq[MAX_DEVICES];          // 转矩电流((66/4096A)/LSB)
+        alignas(32) int16_t speed[MAX_DEVICES];       // 电机转速(1dps/LSB)
+        alignas(32) uint16_t encoder[MAX_DEVICES];    // 编码器位置
+        alignas(32) uint8_t errorState[MAX_DEVICES];  // 错误标志
+        uint64_t status1Mask; // 已收到状态1的设备位图
+        uint64_t status2Mask; // 已收到状态2的设备位图
+    };
+
+    // 全车健康度聚合结果
+    struct FleetHealth {
+        int16_t maxTemperature; // 最高电机温度(℃)，无数据时为 INVALID_TEMPERATURE
+        uint16_t minVoltage;    // 最低母线电压(0.01V)，无数据时为 INVALID_VOLTAGE
+        uint32_t totalCurrent;  // 母线电流总和(0.01A)
+        int32_t maxAbsIq;       // 最大转矩电流绝对值((66/4096A)/LSB)
+        uint64_t errorMask;     // 存在错误标志的设备位图
+        int deviceCount;        // 有状态1数据的设备数
+    };
+
+    static TelemetryStore& getInstance();
+
+    void updateStatus1(int handle, int8_t temperature, uint16_t voltage, uint16_t current, uint8_t errorState);
+    void updateStatus2(int handle, int8_t temperature, int16_t iq, int16_t speed, uint16_t encoder);
+    void updateTemperature(int handle, int8_t temperature);
+    void clear(int handle);
+
+    Table snapshot() const { return table_.load(); }
+    FleetHealth health() const;
+    static FleetHealth aggregate(const Table& table);
+
+private:
+    TelemetryStore();
+    TelemetryStore(const TelemetryStore&) = delete;
+    TelemetryStore& operator=(const TelemetryStore&) = delete;
+
+    Seqlock<Table> table_;
+};
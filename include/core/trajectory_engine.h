@@ -0,0 +1,84 @@
+/**
+ * @file trajectory_engine.h
+ * @brief 位置轨迹下发引擎头文件
+ * @details 从预先装载的路点缓冲区按固定频率逐点下发多圈位置设定值（0xA3/0xA4）
+ *          - 双缓冲：运行中可装载新轨迹到后台缓冲区，在周期边界切换，相邻两点之间没有空档
+ *          - 缓冲区容量在构造时一次分配，装载与下发均不再分配内存
+ *          - 轨迹可循环执行，用于重复路径
+ *          - 自身以一个普通调度的 ControlLoop 任务定频运行；也可不调用 start()，由外部 ControlLoop 以相同频率调用 tick()
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "can_device.h"
+#include "control_loop.h"
+
+// 轨迹路点
+struct Waypoint {
+    int32_t angle;     // 多圈角度(0.01°/LSB)
+    uint16_t maxSpeed; // 到达该点的最大转速(1dps/LSB)，0 表示使用上位机设置的 Max Speed
+};
+
+class TrajectoryEngine {
+public:
+    // 下发统计
+    struct TrajectoryStats {
+        uint64_t ticks;        // 已下发的设定值数
+        uint64_t overruns;     // 落后超过一个周期而跳过的周期数
+        uint64_t sendFailures; // 发送失败的次数
+        uint64_t swaps;        // 切换到新轨迹的次数
+        uint64_t underruns;    // 轨迹结束后没有后续轨迹而停在终点的次数
+    };
+
+    TrajectoryEngine(CANDevice& device, double rateHz, size_t capacity);
+    ~TrajectoryEngine();
+
+    bool start();
+    void stop();
+    bool tick();
+
+    bool load(const Waypoint* points, size_t count, bool loop = false, bool preempt = false);
+    bool load(const std::vector<Waypoint>& points, bool loop = false, bool preempt = false);
+    void cancel();
+
+    bool isIdle() const;
+    size_t getIndex() const;
+    size_t getCapacity() const { return capacity_; }
+    TrajectoryStats getStats() const;
+
+private:
+    // 单个轨迹缓冲区
+    struct Buffer {
+        std::vector<Waypoint> points;
+        size_t count;
+        bool loop;
+    };
+
+    void step();
+    bool nextSetpoint(Waypoint& point);
+
+    CANDevice& device_;
+    int64_t period_ns_;
+    size_t capacity_;
+
+    // 双缓冲：active_ 由下发线程读取，另一个由 load 写入；切换在 mutex_ 下于周期边界进行
+    mutable std::mutex mutex_;
+    Buffer buffers_[2];
+    int active_;
+    size_t index_;     // 活动缓冲区中下一个待下发的路点
+    bool pending_;     // 后台缓冲区已装载，等待切换
+    bool preempt_;     // 切换不等待当前轨迹结束
+    bool finished_;    // 活动轨迹已下发完毕
+
+    ControlLoop loop_;
+
+    std::atomic<uint64_t> ticks_;
+    std::atomic<uint64_t> sendFailures_;
+    std::atomic<uint64_t> swaps_;
+    std::atomic<uint64_t> underruns_;
+};
@@ -14,89 +14,84 @@
 #pragma once
 #include "device_protocol.h"
 #include "can_interface.h"
+#include "motor_codec.h"
+#include "motor_units.h"
+#include "seqlock.h"
+#include "broadcast_ring.h"
+#include "global_config.h"
 #include <typeinfo>  // 为 dynamic_cast 提供支持
+#include <array>
+#include <condition_variable>
+#include <mutex>
 
-enum MOTOR_COMMAND
-{
-    MOTOR_DISABLE = 0x80, // 禁用命令
-    MOTOR_STOP = 0x81,    // 停止命令
-    MOTOR_RUN = 0x88,     // 运行命令
-
-    MOTOR_SYNC_BRAKE = 0x8C, // 同步抱闸器命令
-
-    MOTOR_GET_MULTI_POSITION = 0x92, // 获取多圈位置命令
-    MOTOR_GET_SINGLE_POSITION = 0x94, // 获取单圈位置命令
-
-    MOTOR_GET_STATUS1 = 0x9A, // 获取状态1命令
-    MOTOR_CLEAR_ERROR = 0x9B, // 清除错误命令
-    MOTOR_GET_STATUS2 = 0x9C, // 获取状态2命令
-    MOTOR_GET_STATUS3 = 0x9D, // 获取状态3命令
-
-    MOTOR_TORQUE_FEEDBACK_CONTROL = 0xA1, // 转矩闭环控制命令
-    MOTOR_SPEED_FEEDBACK_CONTROL = 0xA2, // 速度闭环控制命令
-    MOTOR_MULTI_POSITION_FEEDBACK_CONTROL1 = 0xA3, // 多圈位置闭环控制命令1
-    MOTOR_MULTI_POSITION_FEEDBACK_CONTROL2 = 0xA4, // 多圈位置闭环控制命令2
-    MOTOR_SINGLE_POSITION_FEEDBACK_CONTROL1 = 0xA5, // 单圈位置闭环控制命令1
-    MOTOR_SINGLE_POSITION_FEEDBACK_CONTROL2 = 0xA6, // 单圈位置闭环控制命令2
-    MOTOR_INCREMENTAL_POSITION_FEEDBACK_CONTROL1 = 0xA7, // 增量位置闭环控制命令1
-    MOTOR_INCREMENTAL_POSITION_FEEDBACK_CONTROL2 = 0xA8, // 增量位置闭环控制命令2
-};
-
-enum MOTOR_STATE
-{
-    ON = 0x00, // 电机开启
-    OFF = 0x10 // 电机关闭
-};
-
-enum BRAKE_CMD
-{
-    BRAKE_ON = 0x00,        // 抱闸器断电，刹车启动
-    BRAKE_OFF = 0x01,       // 抱闸器通电，刹车释放
-    BRAKE_GET_STATUS = 0x10 // 获取抱闸器状态
-};
-
-typedef struct
-{
-    int8_t temperature;     // 电机温度(1℃/LSB)
-    uint16_t voltage;       // 母线电压(0.01V/LSB)
-    uint16_t current;       // 母线电流(0.01A/LSB)
-    MOTOR_STATE motorState; // 电机状态
-    uint8_t errorState;     // 错误标志  0位，电压状态（0电压正常，1低压保护）| 3位，温度状态（0温度正常，1过温保护）
-} Status1_t;
-
+/**
+ * @brief 电机遥测快照
+ * @details 汇总各状态/位置读取命令最近一次解析结果，时间戳为 steady_clock 纳秒，
+ *          对应字段从未收到过响应时时间戳为0
+ */
 typedef struct
 {
-    int8_t temperature; // 电机温度(1℃/LSB)
-    int16_t current;    // 转矩电流((66/4096A)/LSB)
-    int16_t speed;      // 电机转速(1dps/LSB)
-    uint16_t encoder;   // 编码器位置值(14bit编码器的数值范围0~16383，16bit编码器的数值范围0~65535)
-} Status2_t;
+    Status1_t status1;
+    Status2_t status2;
+    Status3_t status3;
+    int64_t multi_position;   // 多圈位置(0.01°/LSB)
+    uint32_t single_position; // 单圈位置(0.01°/LSB)
+
+    int64_t status1_ns;
+    int64_t status2_ns;
+    int64_t status3_ns;
+    int64_t multi_position_ns;
+    int64_t single_position_ns;
+    int64_t timestamp_ns;     // 任一字段最近一次更新时间
+} MotorTelemetry;
 
+/**
+ * @brief 电机遥测样本
+ * @details 解析函数每解析一帧状态/位置响应就向广播环发布一条，layout 决定联合体中哪个字段有效
+ */
 typedef struct
 {
-    int8_t temperature; // 电机温度(1℃/LSB)
-    int16_t current_A;  // A相电流数据((66/4096 A) / LSB)
-    int16_t current_B;  // B相电流数据((66/4096 A) / LSB)
-    int16_t current_C;  // C相电流数据((66/4096 A) / LSB)
-} Status3_t;
-
-class CANDevice : public Device
+    MotorReplyLayout layout; // STATUS1/STATUS2/STATUS3/MULTI_POSITION/SINGLE_POSITION/BRAKE
+    uint8_t command;         // 响应命令字节
+    int64_t timestamp_ns;    // 接收时间(steady_clock)
+    union {
+        Status1_t status1;
+        Status2_t status2;
+        Status3_t status3;
+        int64_t multi_position;   // 多圈位置(0.01°/LSB)
+        uint32_t single_position; // 单圈位置(0.01°/LSB)
+        uint8_t brake;            // 抱闸器状态 BRAKE_CMD
+    };
+} MotorSample;
+
+using TelemetryRing = BroadcastRing<MotorSample, TELEMETRY_RING_CAPACITY>;
+
+class CANDevice final : public Device
 {
 public:
+    static constexpr const char *PROTOCOL = "CAN";
+
     CANDevice(const std::string &id);
+    ~CANDevice() override;
 
     bool connect() override;
     bool disconnect() override;
     bool sendCommand(uint8_t command, const uint8_t *data = nullptr, uint8_t response_cmd = 0, uint32_t timeout_ms = 50) override;
-    void setInterface(Interface& interface) override {
-        CANInterface* can_iface = dynamic_cast<CANInterface*>(&interface);
-        if (can_iface) {
-            this->can_interface_ = can_iface;
-            LOG_DEBUG("设备 " + getId() + " 接口为：" + this->can_interface_->interface_());
-        } else {
-            LOG_ERROR("设备 " + getId() + " 接口类型不匹配，需要CANInterface类型");
-        }
-    }
+    void setInterface(Interface& interface) override;
+    void setInterface(CANInterface& interface);
+
+    bool postCommand(uint8_t command, const uint8_t *data = nullptr);
+    bool postCommand(const MotorFrame &frame) { return postCommand(frame[0], frame.data() + 1); }
+    void buildFrame(uint8_t command, const uint8_t *data, struct can_frame &frame) const;
+    CANInterface* getInterface() const { return can_interface_; }
+    uint32_t replySequence(uint8_t command) const;
+    int getNode() const { return node_; }
+    void setTelemetrySlot(int slot);
+    int getTelemetrySlot() const { return telemetry_slot_; }
+    MotorTelemetry getTelemetry() const;
+    TelemetryRing::Cursor subscribeTelemetry() const { return telemetry_ring_.subscribe(); }
+    bool pollTelemetry(TelemetryRing::Cursor &cursor, MotorSample &sample) const { return telemetry_ring_.read(cursor, sample); }
+    void setReadCacheTtl(uint32_t ttl_ms);
 
     bool motorCtrl(MOTOR_COMMAND cmd);
     bool motorGetStatus(MOTOR_COMMAND cmd);
@@ -106,18 +101,59 @@ public:
 
     bool motorTorqueFeedbackControl(int16_t iqControl);
     bool motorSpeedFeedbackControl(int32_t speedControl);
+    bool motorTorqueFeedbackControl(units::IqCounts iq) { return motorTorqueFeedbackControl(static_cast<int16_t>(iq.raw())); }
+    bool motorSpeedFeedbackControl(units::CentiDps speed) { return motorSpeedFeedbackControl(speed.raw()); }
+    bool motorMultiPositionControl(units::CentiDegrees angle, units::Dps maxSpeed)
+    {
+        return motorMultiPositionControl(static_cast<int32_t>(angle.raw()), static_cast<uint16_t>(maxSpeed.raw()));
+    }
+    bool motorIncrementalPositionControl(units::CentiDegrees increment, units::Dps maxSpeed)
+    {
+        return motorIncrementalPositionControl(static_cast<int32_t>(increment.raw()), static_cast<uint16_t>(maxSpeed.raw()));
+    }
+
+    bool motorMultiPositionControl(int32_t angleControl);
+    bool motorMultiPositionControl(int32_t angleControl, uint16_t maxSpeed);
+    bool motorSinglePositionControl(SPIN_DIRECTION spinDirection, uint32_t angleControl);
+    bool motorSinglePositionControl(SPIN_DIRECTION spinDirection, uint32_t angleControl, uint16_t maxSpeed);
+    bool motorIncrementalPositionControl(int32_t angleIncrement);
+    bool motorIncrementalPositionControl(int32_t angleIncrement, uint16_t maxSpeed);
 
 private:
     bool checkDeviceAlive() override;
     void handleResponse(const struct can_frame &frame);
+    void onAck(const struct can_frame &frame, int64_t now_ns);
+    void onBrake(const struct can_frame &frame, int64_t now_ns);
+    void onStatus1(const struct can_frame &frame, int64_t now_ns);
+    void onStatus2(const struct can_frame &frame, int64_t now_ns);
+    void onStatus3(const struct can_frame &frame, int64_t now_ns);
+    void onMultiPosition(const struct can_frame &frame, int64_t now_ns);
+    void onSinglePosition(const struct can_frame &frame, int64_t now_ns);
+    void onFrame(const struct can_frame &frame);
+    static MotorSample makeSample(MotorReplyLayout layout, const struct can_frame &frame, int64_t now_ns);
+    bool readCommand(uint8_t command, uint32_t timeout_ms);
+    static FrameClass classifyCommand(uint8_t command);
 
     std::unique_ptr<DeviceHeartbeat> heartbeat;
     CANInterface* can_interface_;
-
-    Status1_t status1_; // 电机状态1
-    Status2_t status2_; // 电机状态2
-    Status3_t status3_; // 电机状态3
-
-    int64_t multi_position_; // 多圈位置(正值表示顺时针累计角度，负值表示逆时针累计角度，单位0.01°/LSB)
-    uint32_t single_position_; // 单圈位置(以编码器零点为起始点，顺时针增加，再次到达零点时数值回0，单位0.01°/LSB，数值范围0~36000*减速比-1。)
+    int node_;        // 电机ID，CAN ID 为 0x140 + node_
+    int telemetry_slot_; // TelemetryStore 中的行（设备句柄表下标），-1 表示不写入；在注册接收回调前设置
+    bool last_alive_; // 上一次心跳检测结果
+
+    // 响应序号：接收线程每收到一帧命令响应，对应序号加一并唤醒等待者
+    mutable std::mutex reply_mutex_;
+    std::condition_variable reply_cv_;
+    std::array<uint32_t, 256> reply_seq_;
+    std::array<int64_t, 256> reply_time_ns_; // 最近一次响应时间，用于读取缓存
+    std::array<bool, 256> inflight_;         // 读取命令是否已有请求在途
+    std::array<bool, 256> flight_throttled_; // 在途请求是否因限流未发出
+    int64_t read_cache_ttl_ns_;              // 读取缓存有效期
+
+    // 遥测数据：由接收线程写入，任意线程通过 getTelemetry 无锁读取
+    // multi_position 正值表示顺时针累计角度，负值表示逆时针累计角度
+    // single_position 以编码器零点为起始点，顺时针增加，再次到达零点时数值回0，范围0~36000*减速比-1
+    Seqlock<MotorTelemetry> telemetry_;
+    // 遥测广播：接收线程为唯一生产者，订阅者各自按节奏读取，读得慢只会丢数据，不会拖慢接收线程
+    TelemetryRing telemetry_ring_;
+    uint8_t last_error_state_; // 上一次状态1中的错误标志，仅接收线程访问
 };
@@ -1,17 +1,59 @@
+/**
+ * @file rs232_device.h
+ * @brief RS232设备头文件
+ * @details 串口设备实现，目前对接 LH08 八路继电器板（0x24 协议）
+ *          - 请求通过 RS232Interface 非阻塞发出，应答由串口事件循环线程分帧后唤醒等待者
+ *          - 协议没有序号，同一时间只允许一个请求在途，按功能码匹配应答
+ *          - 等待时间即实际往返时间，不再固定延时
+ * @author zakiu
+ * @date 2026-10-18
+ */
 #pragma once
 #include "device_protocol.h"
+#include "rs232_interface.h"
+#include "lh08_protocol.h"
+#include "global_config.h"
+#include <array>
+#include <condition_variable>
+#include <mutex>
 
 // RS232 设备实现
-class RS232Device : public Device {
+class RS232Device final : public Device {
 public:
+    static constexpr const char* PROTOCOL = "RS232";
+
     RS232Device(const std::string& id);
-    
+    ~RS232Device() override;
+
     bool connect() override;
     bool disconnect() override;
     bool sendCommand(uint8_t command, const uint8_t *data = nullptr, uint8_t response_cmd = 0, uint32_t timeout_ms = 50) override;
-    void setInterface(Interface& interface) override {};
-    
+    bool checkDeviceAlive() override;
+    void setInterface(Interface& interface) override;
+    void setInterface(RS232Interface& interface);
+
+    // LH08 继电器板
+    bool postCommand(uint8_t command, const uint8_t *data = nullptr);
+    bool setRelays(uint8_t mask, uint32_t timeout_ms = LH08_RESPONSE_TIMEOUT_MS);
+    bool setRelay(int pos, bool on, uint32_t timeout_ms = LH08_RESPONSE_TIMEOUT_MS);
+    bool queryRelays(uint32_t timeout_ms = LH08_RESPONSE_TIMEOUT_MS);
+    uint8_t getRelayMask() const { return relay_mask_.load(std::memory_order_acquire); }
+    uint64_t getChecksumErrors() const { return checksum_errors_.load(std::memory_order_relaxed); }
+
 private:
+    bool sendCommandLocked(uint8_t command, const uint8_t *data, uint8_t response_cmd, uint32_t timeout_ms);
+    void onData(const uint8_t* data, size_t length);
+    void handleFrame(const uint8_t* frame);
+
     std::unique_ptr<DeviceHeartbeat> heartbeat;
-    Interface* deviceInterface = nullptr;
+    RS232Interface* deviceInterface = nullptr;
+
+    std::mutex request_mutex_;                  // 串口请求串行化
+    std::mutex reply_mutex_;
+    std::condition_variable reply_cv_;
+    std::array<uint32_t, 256> reply_seq_{};     // 每个功能码已收到的应答数
+    std::atomic<uint8_t> relay_mask_{0};        // 最近一次应答中的继电器状态
+    std::atomic<bool> relay_mask_known_{false}; // relay_mask_ 与板上状态一致：收到应答后置位，请求超时后清除
+    std::atomic<uint64_t> checksum_errors_{0};
+    LH08Parser parser_;                         // 流式分帧器，仅串口事件循环线程访问
 };
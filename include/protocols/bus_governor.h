@@ -0,0 +1,98 @@
+/**
+ * @file bus_governor.h
+ * @brief CAN总线负载调节器头文件
+ * @details 定义令牌桶与总线负载调节器
+ *          - 按设备/按帧类别限制遥测帧发送速率
+ *          - 总线负载超过阈值时自动降低遥测轮询速率
+ *          - 控制帧不受限流影响，保证优先发送
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+// 帧类别
+enum class FrameClass {
+    CONTROL,   // 控制帧（启停、闭环控制、清错等），始终放行
+    TELEMETRY  // 遥测帧（状态/位置读取），受令牌桶限流
+};
+
+/**
+ * @brief 令牌桶
+ * @details 以固定速率补充令牌，桶容量决定允许的突发量
+ * @note 非线程安全，由 BusGovernor 加锁保护
+ */
+class TokenBucket {
+public:
+    TokenBucket(double rate = 0.0, double burst = 1.0)
+        : rate_(rate), burst_(burst), tokens_(burst), last_(std::chrono::steady_clock::now()) {}
+
+    void setRate(double rate) { rate_ = rate; }
+    double rate() const { return rate_; }
+
+    bool tryAcquire(std::chrono::steady_clock::time_point now, double count = 1.0) {
+        double elapsed = std::chrono::duration<double>(now - last_).count();
+        last_ = now;
+        tokens_ = tokens_ + elapsed * rate_;
+        if (tokens_ > burst_) {
+            tokens_ = burst_;
+        }
+        if (tokens_ < count) {
+            return false;
+        }
+        tokens_ -= count;
+        return true;
+    }
+
+private:
+    double rate_;   // 令牌补充速率(个/秒)
+    double burst_;  // 桶容量
+    double tokens_; // 当前令牌数
+    std::chrono::steady_clock::time_point last_;
+};
+
+/**
+ * @brief 总线负载调节器
+ * @details 位于命令下发路径上，决定一帧是否允许发送
+ *          - 每个设备一个遥测令牌桶，另有一个全总线遥测令牌桶
+ *          - 根据 CANInterface 统计的总线利用率调整降频级别，
+ *            每升一级遥测速率减半，负载回落后逐级恢复
+ *          - 控制帧只计数不限流
+ */
+class BusGovernor {
+public:
+    static constexpr int MAX_NODES = 33;    // 电机ID 1~32，0 保留
+    static constexpr int MAX_SHIFT_LEVEL = 4; // 最多降至 1/16 速率
+
+    BusGovernor();
+
+    bool admit(int node, FrameClass cls);
+    void onBusLoad(double load);
+
+    void setTelemetryRate(double perDeviceRate, double busRate);
+    void setThresholds(double high, double low);
+
+    int getShiftLevel() const { return shiftLevel_.load(std::memory_order_relaxed); }
+    uint64_t getThrottledCount() const { return throttled_.load(std::memory_order_relaxed); }
+    uint64_t getControlCount() const { return controlFrames_.load(std::memory_order_relaxed); }
+
+private:
+    void applyRates();
+
+    std::mutex mutex_;
+    std::array<TokenBucket, MAX_NODES> deviceBuckets_;
+    TokenBucket busBucket_;
+
+    double deviceRate_; // 每设备遥测基准速率(帧/秒)
+    double busRate_;    // 全总线遥测基准速率(帧/秒)
+    double highWatermark_; // 由 mutex_ 保护
+    double lowWatermark_;  // 由 mutex_ 保护
+
+    std::atomic<int> shiftLevel_;
+    std::atomic<uint64_t> throttled_;
+    std::atomic<uint64_t> controlFrames_;
+};
@@ -1,23 +1,60 @@
 #pragma once
 
 #include "device_interface.h"
+#include "bus_governor.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <linux/can.h>
 
 class CANInterface : public Interface
 {
 public:
+    using FrameHandler = std::function<void(const struct can_frame &)>;
+
     CANInterface(const std::string &can_interface);
     bool init();
+    bool attachSocket(int fd);
     bool send_frame(const struct can_frame &frame);
     bool receive_frame(struct can_frame &frame, int timeout_ms = 250);
     ~CANInterface();
 
     bool is_JK_platform();
     std::string interface_(){return can_interface_;};
+
+    // 总线负载统计
+    static uint32_t frameBitCount(const struct can_frame &frame);
+    double getBusLoad() const;
+    uint64_t getTotalBits() const { return total_bits_.load(std::memory_order_relaxed); }
+    BusGovernor& governor() { return governor_; }
+
+    // 接收分发：按 CAN ID 将收到的帧交给对应设备
+    void addReceiver(canid_t can_id, FrameHandler handler);
+    void removeReceiver(canid_t can_id);
+    bool startReceiver();
+    void stopReceiver();
+    bool isReceiving() const { return receiving_; }
     
 private:
+    void accountFrame(const struct can_frame &frame);
+    void receiveLoop();
+
     std::string can_interface_;
     int sock_;
-};
 
+    uint32_t bitrate_;                      // 总线位速率(bit/s)
+    std::atomic<uint64_t> total_bits_;      // 累计占用位数
+    std::atomic<uint64_t> window_bits_;     // 当前统计窗口内的位数
+    std::atomic<int64_t> window_start_ns_;  // 当前统计窗口起始时间
+    std::atomic<double> bus_load_;          // 上一个窗口的总线利用率
+    BusGovernor governor_;
+
+    std::unordered_map<canid_t, FrameHandler> receivers_;
+    std::mutex receiversMutex_;
+    std::atomic<bool> receiving_;
+    std::thread receiveThread_;
+};
@@ -0,0 +1,199 @@
+/**
+ * @file lh08_protocol.h
+ * @brief LH08 八路继电器板串口协议定义
+ * @details 请求与应答均为13字节定长帧：
+ *          0x24 | 地址 0x01 | 0x0A | 功能码 | 继电器1~8状态 | sum8 校验（前12字节累加和）
+ *          - 功能码 0x00 查询，0x01 设置
+ *          - 继电器状态 0x01 断开，0x02 吸合
+ *          - 应答帧回显功能码，继电器字段为执行后的实际状态
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+static constexpr uint8_t LH08_HEADER = 0x24;
+static constexpr uint8_t LH08_ADDRESS = 0x01;
+static constexpr uint8_t LH08_LENGTH = 0x0A;
+static constexpr size_t LH08_FRAME_SIZE = 13;
+static constexpr int LH08_RELAY_COUNT = 8;
+
+enum LH08_FUNCTION : uint8_t {
+    LH08_QUERY = 0x00,
+    LH08_SET = 0x01
+};
+
+enum LH08_RELAY_STATE : uint8_t {
+    LH08_RELAY_OFF = 0x01,
+    LH08_RELAY_ON = 0x02
+};
+
+/**
+ * @brief 计算 sum8 校验
+ * @param data 数据
+ * @param length 参与校验的字节数
+ * @return uint8_t 累加和低8位
+ */
+inline uint8_t lh08Sum8(const uint8_t* data, size_t length)
+{
+    uint8_t sum = 0;
+    for (size_t i = 0; i < length; i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief 组装请求帧
+ * @param function 功能码
+ * @param relays 8路继电器状态(LH08_RELAY_STATE)，查询帧传 nullptr，继电器字段填0
+ * @param frame 输出帧缓冲区
+ */
+inline void lh08EncodeFrame(uint8_t function, const uint8_t* relays, uint8_t frame[LH08_FRAME_SIZE])
+{
+    frame[0] = LH08_HEADER;
+    frame[1] = LH08_ADDRESS;
+    frame[2] = LH08_LENGTH;
+    frame[3] = function;
+    for (int i = 0; i < LH08_RELAY_COUNT; i++) {
+        frame[4 + i] = relays ? relays[i] : 0x00;
+    }
+    frame[12] = lh08Sum8(frame, 12);
+}
+
+/**
+ * @brief 将继电器位图展开为8路状态
+ * @param mask 继电器状态位图，bit0 对应继电器1，置位为吸合
+ * @param relays 输出8路继电器状态
+ */
+inline void lh08RelayStates(uint8_t mask, uint8_t relays[LH08_RELAY_COUNT])
+{
+    for (int i = 0; i < LH08_RELAY_COUNT; i++) {
+        relays[i] = (mask & (1u << i)) ? LH08_RELAY_ON : LH08_RELAY_OFF;
+    }
+}
+
+/**
+ * @brief 校验一帧是否为合法的 LH08 帧
+ * @param frame 13字节帧
+ * @return bool 帧头、地址、长度和校验均正确时返回true
+ */
+inline bool lh08ValidFrame(const uint8_t frame[LH08_FRAME_SIZE])
+{
+    return frame[0] == LH08_HEADER && frame[1] == LH08_ADDRESS && frame[2] == LH08_LENGTH &&
+           lh08Sum8(frame, 12) == frame[12];
+}
+
+/**
+ * @brief 从应答帧中取出继电器状态位图
+ * @param frame 13字节帧
+ * @return uint8_t 继电器状态位图，bit0 对应继电器1
+ */
+inline uint8_t lh08DecodeRelayMask(const uint8_t frame[LH08_FRAME_SIZE])
+{
+    uint8_t mask = 0;
+    for (int i = 0; i < LH08_RELAY_COUNT; i++) {
+        if (frame[4 + i] == LH08_RELAY_ON) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+}
+
+/**
+ * @brief LH08 流式分帧器
+ * @details 逐字节状态机，可按任意边界喂入数据：
+ *          - 未同步时丢弃字节直到遇到帧头 0x24
+ *          - 地址或长度字段不符时立即在已收字节中重新寻找帧头
+ *          - 凑满13字节后校验 sum8，正确则回调完整帧，错误则从帧头之后的字节重新同步
+ *          - 只使用内部定长缓冲区，不分配内存
+ */
+class LH08Parser {
+public:
+    /**
+     * @brief 喂入一段数据
+     * @param data 数据
+     * @param length 字节数
+     * @param onFrame 完整帧回调，参数为指向13字节帧的指针，仅在回调期间有效
+     * @return size_t 本次解析出的完整帧数
+     */
+    template <typename Handler>
+    size_t feed(const uint8_t* data, size_t length, Handler&& onFrame)
+    {
+        size_t frames = 0;
+        for (size_t i = 0; i < length; i++) {
+            frames += push(data[i], onFrame);
+        }
+        return frames;
+    }
+
+    void reset() { have_ = 0; }
+
+    uint64_t getFrameCount() const { return frameCount_; }
+    uint64_t getChecksumErrors() const { return checksumErrors_; }
+    uint64_t getDiscardedBytes() const { return discardedBytes_; }
+
+private:
+    template <typename Handler>
+    size_t push(uint8_t byte, Handler& onFrame)
+    {
+        if (have_ == 0 && byte != LH08_HEADER) {
+            discardedBytes_++;
+            return 0;
+        }
+        buffer_[have_++] = byte;
+        if (!prefixValid()) {
+            resync(1);
+            return 0;
+        }
+        if (have_ < LH08_FRAME_SIZE) {
+            return 0;
+        }
+        if (lh08Sum8(buffer_, 12) == buffer_[12]) {
+            frameCount_++;
+            have_ = 0;
+            onFrame(static_cast<const uint8_t*>(buffer_));
+            return 1;
+        }
+        checksumErrors_++;
+        resync(1);
+        return 0;
+    }
+
+    // 已收字节是否可能是合法帧的开头
+    bool prefixValid() const
+    {
+        return (have_ < 2 || buffer_[1] == LH08_ADDRESS) && (have_ < 3 || buffer_[2] == LH08_LENGTH);
+    }
+
+    // 从 from 开始在已收字节中寻找下一个可能的帧头，并把其后的字节移到缓冲区开头
+    void resync(size_t from)
+    {
+        size_t start = from;
+        while (start < have_) {
+            if (buffer_[start] == LH08_HEADER) {
+                size_t remain = have_ - start;
+                for (size_t i = 0; i < remain; i++) {
+                    buffer_[i] = buffer_[start + i];
+                }
+                discardedBytes_ += start;
+                have_ = remain;
+                if (prefixValid()) {
+                    return;
+                }
+                start = 1;
+                continue;
+            }
+            start++;
+        }
+        discardedBytes_ += have_;
+        have_ = 0;
+    }
+
+    uint8_t buffer_[LH08_FRAME_SIZE] = {};
+    size_t have_ = 0;
+    uint64_t frameCount_ = 0;
+    uint64_t checksumErrors_ = 0;
+    uint64_t discardedBytes_ = 0;
+};
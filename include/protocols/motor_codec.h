@@ -0,0 +1,312 @@
+/**
+ * @file motor_codec.h
+ * @brief LK 电机 CAN 协议编解码描述
+ * @details 以编译期描述符定义每条命令的请求字段与响应布局，编码器、解码器和响应分发表均在编译期生成
+ *          - MotorField 描述帧内字段的偏移、宽度与单位（LSB 对应的物理量），按小端读写，窄于类型宽度的有符号字段自动符号扩展
+ *          - MotorCommandCodec 由命令字节、响应布局和请求字段列表组成，encode() 生成完整的8字节帧数据，未使用的字节为0
+ *          - motorReplyLayout() 由命令列表在编译期生成 256 项查找表，接收线程按命令字节直接查表
+ *          - 全部为 constexpr/inline，无分配、无虚调用
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ratio>
+#include <type_traits>
+
+enum MOTOR_COMMAND
+{
+    MOTOR_DISABLE = 0x80, // 禁用命令
+    MOTOR_STOP = 0x81,    // 停止命令
+    MOTOR_RUN = 0x88,     // 运行命令
+
+    MOTOR_SYNC_BRAKE = 0x8C, // 同步抱闸器命令
+
+    MOTOR_GET_MULTI_POSITION = 0x92, // 获取多圈位置命令
+    MOTOR_GET_SINGLE_POSITION = 0x94, // 获取单圈位置命令
+
+    MOTOR_GET_STATUS1 = 0x9A, // 获取状态1命令
+    MOTOR_CLEAR_ERROR = 0x9B, // 清除错误命令
+    MOTOR_GET_STATUS2 = 0x9C, // 获取状态2命令
+    MOTOR_GET_STATUS3 = 0x9D, // 获取状态3命令
+
+    MOTOR_TORQUE_FEEDBACK_CONTROL = 0xA1, // 转矩闭环控制命令
+    MOTOR_SPEED_FEEDBACK_CONTROL = 0xA2, // 速度闭环控制命令
+    MOTOR_MULTI_POSITION_FEEDBACK_CONTROL1 = 0xA3, // 多圈位置闭环控制命令1
+    MOTOR_MULTI_POSITION_FEEDBACK_CONTROL2 = 0xA4, // 多圈位置闭环控制命令2
+    MOTOR_SINGLE_POSITION_FEEDBACK_CONTROL1 = 0xA5, // 单圈位置闭环控制命令1
+    MOTOR_SINGLE_POSITION_FEEDBACK_CONTROL2 = 0xA6, // 单圈位置闭环控制命令2
+    MOTOR_INCREMENTAL_POSITION_FEEDBACK_CONTROL1 = 0xA7, // 增量位置闭环控制命令1
+    MOTOR_INCREMENTAL_POSITION_FEEDBACK_CONTROL2 = 0xA8, // 增量位置闭环控制命令2
+};
+
+enum MOTOR_STATE
+{
+    ON = 0x00, // 电机开启
+    OFF = 0x10 // 电机关闭
+};
+
+enum SPIN_DIRECTION
+{
+    SPIN_CLOCKWISE = 0x00,        // 顺时针
+    SPIN_COUNTERCLOCKWISE = 0x01  // 逆时针
+};
+
+enum BRAKE_CMD
+{
+    BRAKE_ON = 0x00,        // 抱闸器断电，刹车启动
+    BRAKE_OFF = 0x01,       // 抱闸器通电，刹车释放
+    BRAKE_GET_STATUS = 0x10 // 获取抱闸器状态
+};
+
+typedef struct
+{
+    int8_t temperature;     // 电机温度(1℃/LSB)
+    uint16_t voltage;       // 母线电压(0.01V/LSB)
+    uint16_t current;       // 母线电流(0.01A/LSB)
+    MOTOR_STATE motorState; // 电机状态
+    uint8_t errorState;     // 错误标志  0位，电压状态（0电压正常，1低压保护）| 3位，温度状态（0温度正常，1过温保护）
+} Status1_t;
+
+typedef struct
+{
+    int8_t temperature; // 电机温度(1℃/LSB)
+    int16_t current;    // 转矩电流((66/4096A)/LSB)
+    int16_t speed;      // 电机转速(1dps/LSB)
+    uint16_t encoder;   // 编码器位置值(14bit编码器的数值范围0~16383，16bit编码器的数值范围0~65535)
+} Status2_t;
+
+typedef struct
+{
+    int8_t temperature; // 电机温度(1℃/LSB)
+    int16_t current_A;  // A相电流数据((66/4096 A) / LSB)
+    int16_t current_B;  // B相电流数据((66/4096 A) / LSB)
+    int16_t current_C;  // C相电流数据((66/4096 A) / LSB)
+} Status3_t;
+
+// 8字节帧数据，data[0] 为命令字节
+using MotorFrame = std::array<uint8_t, 8>;
+
+// 常用单位：LSB 对应的物理量
+using UnitOne = std::ratio<1>;
+using UnitCenti = std::ratio<1, 100>;       // 0.01
+using UnitIq = std::ratio<66, 4096>;        // 转矩电流 (66/4096)A
+
+/**
+ * @brief 帧内字段描述
+ * @tparam T 字段值类型
+ * @tparam Offset 帧内字节偏移(1~7)
+ * @tparam Width 字段字节数，默认为类型宽度
+ * @tparam Unit 1 LSB 对应的物理量
+ */
+template <typename T, size_t Offset, size_t Width = sizeof(T), typename Unit = UnitOne>
+struct MotorField {
+    static_assert(Offset >= 1 && Offset + Width <= 8, "字段超出帧数据范围");
+    static_assert(Width >= 1 && Width <= sizeof(T), "字段宽度不能超过值类型宽度");
+
+    using type = T;
+    static constexpr size_t offset = Offset;
+    static constexpr size_t width = Width;
+    static constexpr double lsb = static_cast<double>(Unit::num) / Unit::den;
+
+    static constexpr void put(MotorFrame& frame, T value)
+    {
+        using U = std::make_unsigned_t<std::conditional_t<std::is_enum<T>::value, int, T>>;
+        U raw = static_cast<U>(value);
+        for (size_t i = 0; i < Width; i++)
+        {
+            frame[Offset + i] = static_cast<uint8_t>(raw >> (8 * i));
+        }
+    }
+
+    static constexpr T get(const uint8_t* data)
+    {
+        using U = std::make_unsigned_t<std::conditional_t<std::is_enum<T>::value, int, T>>;
+        U raw = 0;
+        for (size_t i = 0; i < Width; i++)
+        {
+            raw |= static_cast<U>(static_cast<U>(data[Offset + i]) << (8 * i));
+        }
+        if constexpr (std::is_signed<T>::value && Width < sizeof(T))
+        {
+            // 窄字段符号扩展
+            constexpr size_t shift = 8 * (sizeof(T) - Width);
+            return static_cast<T>(static_cast<T>(raw << shift) >> shift);
+        }
+        return static_cast<T>(raw);
+    }
+
+    static constexpr double toPhysical(T value) { return static_cast<double>(value) * lsb; }
+};
+
+// 响应布局
+enum class MotorReplyLayout : uint8_t {
+    NONE,            // 非电机命令或未知命令
+    ACK,             // 回显命令字节，无数据
+    BRAKE,           // 抱闸器状态
+    STATUS1,
+    STATUS2,         // 状态2，闭环控制命令的响应也使用此布局
+    STATUS3,
+    MULTI_POSITION,
+    SINGLE_POSITION,
+    COUNT
+};
+
+// 各响应布局的字段与解码器
+struct AckReply {
+    static constexpr MotorReplyLayout layout = MotorReplyLayout::ACK;
+};
+
+struct BrakeReply {
+    static constexpr MotorReplyLayout layout = MotorReplyLayout::BRAKE;
+    using State = MotorField<uint8_t, 1>;
+    static constexpr uint8_t decode(const uint8_t* data) { return State::get(data); }
+};
+
+struct Status1Reply {
+    static constexpr MotorReplyLayout layout = MotorReplyLayout::STATUS1;
+    using Temperature = MotorField<int8_t, 1>;
+    using Voltage = MotorField<uint16_t, 2, 2, UnitCenti>;
+    using Current = MotorField<uint16_t, 4, 2, UnitCenti>;
+    using State = MotorField<uint8_t, 6>;
+    using Error = MotorField<uint8_t, 7>;
+
+    static constexpr Status1_t decode(const uint8_t* data)
+    {
+        return Status1_t{Temperature::get(data), Voltage::get(data), Current::get(data),
+                         static_cast<MOTOR_STATE>(State::get(data)), Error::get(data)};
+    }
+};
+
+struct Status2Reply {
+    static constexpr MotorReplyLayout layout = MotorReplyLayout::STATUS2;
+    using Temperature = MotorField<int8_t, 1>;
+    using Current = MotorField<int16_t, 2, 2, UnitIq>;
+    using Speed = MotorField<int16_t, 4>;
+    using Encoder = MotorField<uint16_t, 6>;
+
+    static constexpr Status2_t decode(const uint8_t* data)
+    {
+        return Status2_t{Temperature::get(data), Current::get(data), Speed::get(data), Encoder::get(data)};
+    }
+};
+
+struct Status3Reply {
+    static constexpr MotorReplyLayout layout = MotorReplyLayout::STATUS3;
+    using Temperature = MotorField<int8_t, 1>;
+    using CurrentA = MotorField<int16_t, 2, 2, UnitIq>;
+    using CurrentB = MotorField<int16_t, 4, 2, UnitIq>;
+    using CurrentC = MotorField<int16_t, 6, 2, UnitIq>;
+
+    static constexpr Status3_t decode(const uint8_t* data)
+    {
+        return Status3_t{Temperature::get(data), CurrentA::get(data), CurrentB::get(data), CurrentC::get(data)};
+    }
+};
+
+struct MultiPositionReply {
+    static constexpr MotorReplyLayout layout = MotorReplyLayout::MULTI_POSITION;
+    using Angle = MotorField<int64_t, 1, 7, UnitCenti>; // 7字节有符号数
+    static constexpr int64_t decode(const uint8_t* data) { return Angle::get(data); }
+};
+
+struct SinglePositionReply {
+    static constexpr MotorReplyLayout layout = MotorReplyLayout::SINGLE_POSITION;
+    using Angle = MotorField<uint32_t, 4, 4, UnitCenti>;
+    static constexpr uint32_t decode(const uint8_t* data) { return Angle::get(data); }
+};
+
+/**
+ * @brief 命令描述符
+ * @tparam Command 命令字节
+ * @tparam Reply 响应布局
+ * @tparam Fields 请求字段，encode() 的参数按此顺序
+ */
+template <uint8_t Command, typename Reply, typename... Fields>
+struct MotorCommandCodec {
+    static constexpr uint8_t command = Command;
+    using reply = Reply;
+
+    static constexpr MotorFrame encode(typename Fields::type... values)
+    {
+        MotorFrame frame{};
+        frame[0] = Command;
+        (Fields::put(frame, values), ...);
+        return frame;
+    }
+};
+
+// 命令描述符
+namespace MotorCodec {
+using Disable = MotorCommandCodec<MOTOR_DISABLE, AckReply>;
+using Stop = MotorCommandCodec<MOTOR_STOP, AckReply>;
+using Run = MotorCommandCodec<MOTOR_RUN, AckReply>;
+using SyncBrake = MotorCommandCodec<MOTOR_SYNC_BRAKE, BrakeReply, MotorField<BRAKE_CMD, 1, 1>>;
+using GetMultiPosition = MotorCommandCodec<MOTOR_GET_MULTI_POSITION, MultiPositionReply>;
+using GetSinglePosition = MotorCommandCodec<MOTOR_GET_SINGLE_POSITION, SinglePositionReply>;
+using GetStatus1 = MotorCommandCodec<MOTOR_GET_STATUS1, Status1Reply>;
+using ClearError = MotorCommandCodec<MOTOR_CLEAR_ERROR, Status1Reply>;
+using GetStatus2 = MotorCommandCodec<MOTOR_GET_STATUS2, Status2Reply>;
+using GetStatus3 = MotorCommandCodec<MOTOR_GET_STATUS3, Status3Reply>;
+
+// 转矩闭环：iqControl(-2048~2048) 位于 data[4..5]
+using TorqueControl = MotorCommandCodec<MOTOR_TORQUE_FEEDBACK_CONTROL, Status2Reply,
+                                        MotorField<int16_t, 4, 2, UnitIq>>;
+// 速度闭环：speedControl(0.01dps/LSB) 位于 data[4..7]
+using SpeedControl = MotorCommandCodec<MOTOR_SPEED_FEEDBACK_CONTROL, Status2Reply,
+                                       MotorField<int32_t, 4, 4, UnitCenti>>;
+// 多圈位置：angleControl(0.01°/LSB)
+using MultiPositionControl1 = MotorCommandCodec<MOTOR_MULTI_POSITION_FEEDBACK_CONTROL1, Status2Reply,
+                                                MotorField<int32_t, 4, 4, UnitCenti>>;
+// 多圈位置带速度限制：maxSpeed(1dps/LSB), angleControl(0.01°/LSB)
+using MultiPositionControl2 = MotorCommandCodec<MOTOR_MULTI_POSITION_FEEDBACK_CONTROL2, Status2Reply,
+                                                MotorField<uint16_t, 2>, MotorField<int32_t, 4, 4, UnitCenti>>;
+// 单圈位置：spinDirection, angleControl(0.01°/LSB, 0~35999)
+using SinglePositionControl1 = MotorCommandCodec<MOTOR_SINGLE_POSITION_FEEDBACK_CONTROL1, Status2Reply,
+                                                 MotorField<SPIN_DIRECTION, 1, 1>, MotorField<uint32_t, 4, 4, UnitCenti>>;
+// 单圈位置带速度限制：spinDirection, maxSpeed(1dps/LSB), angleControl(0.01°/LSB)
+using SinglePositionControl2 = MotorCommandCodec<MOTOR_SINGLE_POSITION_FEEDBACK_CONTROL2, Status2Reply,
+                                                 MotorField<SPIN_DIRECTION, 1, 1>, MotorField<uint16_t, 2>,
+                                                 MotorField<uint32_t, 4, 4, UnitCenti>>;
+// 增量位置：angleIncrement(0.01°/LSB)
+using IncrementalPositionControl1 = MotorCommandCodec<MOTOR_INCREMENTAL_POSITION_FEEDBACK_CONTROL1, Status2Reply,
+                                                      MotorField<int32_t, 4, 4, UnitCenti>>;
+// 增量位置带速度限制：maxSpeed(1dps/LSB), angleIncrement(0.01°/LSB)
+using IncrementalPositionControl2 = MotorCommandCodec<MOTOR_INCREMENTAL_POSITION_FEEDBACK_CONTROL2, Status2Reply,
+                                                      MotorField<uint16_t, 2>, MotorField<int32_t, 4, 4, UnitCenti>>;
+
+template <typename... Codecs>
+struct List {};
+
+using All = List<Disable, Stop, Run, SyncBrake, GetMultiPosition, GetSinglePosition,
+                 GetStatus1, ClearError, GetStatus2, GetStatus3,
+                 TorqueControl, SpeedControl, MultiPositionControl1, MultiPositionControl2,
+                 SinglePositionControl1, SinglePositionControl2,
+                 IncrementalPositionControl1, IncrementalPositionControl2>;
+
+template <typename... Codecs>
+constexpr std::array<MotorReplyLayout, 256> buildReplyTable(List<Codecs...>)
+{
+    std::array<MotorReplyLayout, 256> table{};
+    ((table[Codecs::command] = Codecs::reply::layout), ...);
+    return table;
+}
+
+// 命令字节 → 响应布局
+inline constexpr std::array<MotorReplyLayout, 256> replyTable = buildReplyTable(All{});
+} // namespace MotorCodec
+
+constexpr MotorReplyLayout motorReplyLayout(uint8_t command)
+{
+    return MotorCodec::replyTable[command];
+}
+
+static_assert(motorReplyLayout(MOTOR_GET_STATUS2) == MotorReplyLayout::STATUS2, "响应分发表生成错误");
+static_assert(motorReplyLayout(MOTOR_CLEAR_ERROR) == MotorReplyLayout::STATUS1, "响应分发表生成错误");
+static_assert(motorReplyLayout(0x00) == MotorReplyLayout::NONE, "响应分发表生成错误");
+static_assert(MotorCodec::SpeedControl::encode(-2)[4] == 0xFE && MotorCodec::SpeedControl::encode(-2)[7] == 0xFF,
+              "速度命令编码错误");
+static_assert(MultiPositionReply::decode(MotorFrame{0x92, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}.data()) == -1,
+              "多圈位置符号扩展错误");
@@ -0,0 +1,127 @@
+/**
+ * @file motor_units.h
+ * @brief 电机物理量的定点强类型
+ * @details 以整数保存协议原始值，类型同时携带物理量种类与 LSB 对应的比例
+ *          - 不同物理量之间不能相加、比较或赋值，编译期报错
+ *          - 同一物理量在比例之间的无损转换（如 dps → 0.01dps）可隐式进行，有损转换必须用 unit_cast 显式四舍五入
+ *          - 全部为 constexpr 整数运算，控制路径不引入浮点；value() 仅用于日志和显示
+ *          - 运动曲线、运动学等以浮点计算的设定值由 from_value 一次四舍五入为原始值，比例只在本文件中出现
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <cstdint>
+#include <ratio>
+#include <type_traits>
+
+namespace units {
+
+// 物理量种类
+struct VoltageTag {};
+struct CurrentTag {};
+struct TorqueCurrentTag {};
+struct SpeedTag {};
+struct AngleTag {};
+struct TemperatureTag {};
+
+/**
+ * @brief 定点物理量
+ * @tparam Tag 物理量种类
+ * @tparam Rep 原始值的整数类型
+ * @tparam Scale 1 LSB 对应的物理量(国际单位或度)
+ */
+template <typename Tag, typename Rep, typename Scale>
+class Quantity {
+    static_assert(std::is_integral<Rep>::value, "定点物理量的原始值必须是整数");
+
+public:
+    using tag = Tag;
+    using rep = Rep;
+    using scale = Scale;
+
+    constexpr Quantity() : raw_(0) {}
+    constexpr explicit Quantity(Rep raw) : raw_(raw) {}
+
+    // 同种物理量、比例可整除时的无损隐式转换
+    template <typename Rep2, typename Scale2,
+              typename = std::enable_if_t<std::ratio_divide<Scale2, Scale>::den == 1>>
+    constexpr Quantity(const Quantity<Tag, Rep2, Scale2>& other)
+        : raw_(static_cast<Rep>(other.raw() * std::ratio_divide<Scale2, Scale>::num)) {}
+
+    constexpr Rep raw() const { return raw_; }
+    constexpr double value() const { return static_cast<double>(raw_) * Scale::num / Scale::den; }
+
+    constexpr Quantity operator-() const { return Quantity(static_cast<Rep>(-raw_)); }
+    constexpr Quantity& operator+=(Quantity other) { raw_ += other.raw_; return *this; }
+    constexpr Quantity& operator-=(Quantity other) { raw_ -= other.raw_; return *this; }
+
+    friend constexpr Quantity operator+(Quantity a, Quantity b) { return Quantity(static_cast<Rep>(a.raw_ + b.raw_)); }
+    friend constexpr Quantity operator-(Quantity a, Quantity b) { return Quantity(static_cast<Rep>(a.raw_ - b.raw_)); }
+    friend constexpr Quantity operator*(Quantity a, Rep k) { return Quantity(static_cast<Rep>(a.raw_ * k)); }
+    friend constexpr Quantity operator*(Rep k, Quantity a) { return Quantity(static_cast<Rep>(a.raw_ * k)); }
+    friend constexpr Quantity operator/(Quantity a, Rep k) { return Quantity(static_cast<Rep>(a.raw_ / k)); }
+
+    friend constexpr bool operator==(Quantity a, Quantity b) { return a.raw_ == b.raw_; }
+    friend constexpr bool operator!=(Quantity a, Quantity b) { return a.raw_ != b.raw_; }
+    friend constexpr bool operator<(Quantity a, Quantity b) { return a.raw_ < b.raw_; }
+    friend constexpr bool operator<=(Quantity a, Quantity b) { return a.raw_ <= b.raw_; }
+    friend constexpr bool operator>(Quantity a, Quantity b) { return a.raw_ > b.raw_; }
+    friend constexpr bool operator>=(Quantity a, Quantity b) { return a.raw_ >= b.raw_; }
+
+private:
+    Rep raw_;
+};
+
+/**
+ * @brief 同种物理量之间的显式转换，有损时四舍五入（远离零）
+ */
+template <typename To, typename Tag, typename Rep, typename Scale>
+constexpr To unit_cast(const Quantity<Tag, Rep, Scale>& from)
+{
+    static_assert(std::is_same<typename To::tag, Tag>::value, "不同物理量之间不能转换");
+    using Factor = std::ratio_divide<Scale, typename To::scale>;
+    int64_t scaled = static_cast<int64_t>(from.raw()) * Factor::num;
+    int64_t half = Factor::den / 2;
+    int64_t raw = scaled >= 0 ? (scaled + half) / Factor::den : (scaled - half) / Factor::den;
+    return To(static_cast<typename To::rep>(raw));
+}
+
+/**
+ * @brief 由物理量的浮点值（国际单位或度）构造定点值，四舍五入（远离零）
+ * @tparam To 目标定点类型
+ * @param value 浮点值，如 dps、°
+ */
+template <typename To>
+constexpr To from_value(double value)
+{
+    double raw = value * To::scale::den / To::scale::num;
+    return To(static_cast<typename To::rep>(raw >= 0 ? raw + 0.5 : raw - 0.5));
+}
+
+// 协议中的物理量
+using CentiVolts = Quantity<VoltageTag, int32_t, std::centi>;                // 母线电压 0.01V/LSB
+using CentiAmps = Quantity<CurrentTag, int32_t, std::centi>;                 // 母线电流 0.01A/LSB
+using IqCounts = Quantity<TorqueCurrentTag, int32_t, std::ratio<66, 4096>>;  // 转矩电流 (66/4096)A/LSB
+using MilliAmpsIq = Quantity<TorqueCurrentTag, int32_t, std::milli>;         // 转矩电流 1mA/LSB
+using Dps = Quantity<SpeedTag, int32_t, std::ratio<1>>;                      // 转速 1dps/LSB
+using CentiDps = Quantity<SpeedTag, int32_t, std::centi>;                    // 转速 0.01dps/LSB
+using Degrees = Quantity<AngleTag, int64_t, std::ratio<1>>;                  // 角度 1°/LSB
+using CentiDegrees = Quantity<AngleTag, int64_t, std::centi>;                // 角度 0.01°/LSB
+using Celsius = Quantity<TemperatureTag, int32_t, std::ratio<1>>;            // 温度 1℃/LSB
+
+namespace literals {
+constexpr Dps operator""_dps(unsigned long long v) { return Dps(static_cast<int32_t>(v)); }
+constexpr CentiDps operator""_cdps(unsigned long long v) { return CentiDps(static_cast<int32_t>(v)); }
+constexpr Degrees operator""_deg(unsigned long long v) { return Degrees(static_cast<int64_t>(v)); }
+constexpr CentiDegrees operator""_cdeg(unsigned long long v) { return CentiDegrees(static_cast<int64_t>(v)); }
+constexpr IqCounts operator""_iq(unsigned long long v) { return IqCounts(static_cast<int32_t>(v)); }
+} // namespace literals
+
+static_assert(CentiDps(Dps(3)).raw() == 300, "无损转换错误");
+static_assert(unit_cast<Dps>(CentiDps(-250)).raw() == -3, "有损转换应四舍五入");
+static_assert(unit_cast<MilliAmpsIq>(IqCounts(2048)).raw() == 33000, "转矩电流换算错误");
+static_assert(from_value<CentiDps>(1.234).raw() == 123 && from_value<Dps>(-2.5).raw() == -3, "浮点设定值应四舍五入");
+static_assert(!std::is_convertible<CentiDps, Dps>::value, "有损转换不应隐式进行");
+static_assert(!std::is_convertible<Dps, CentiDegrees>::value, "不同物理量不应互相转换");
+
+} // namespace units
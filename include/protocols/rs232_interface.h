@@ -0,0 +1,53 @@
+#pragma once
+
+#include "device_interface.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <termios.h>
+
+/**
+ * @brief 串口接口
+ * @details 串口以非阻塞方式打开，由一个基于 epoll 的事件循环线程负责收发
+ *          - 收到的数据以整块形式交给接收回调，由设备自行分帧
+ *          - 写入时先尝试直接写出，写不完的部分缓存起来等串口可写时继续发送
+ *          - CAN 帧收发接口不适用于串口，始终返回 false
+ */
+class RS232Interface : public Interface
+{
+public:
+    using DataHandler = std::function<void(const uint8_t *data, size_t length)>;
+
+    RS232Interface(const std::string &port, speed_t baudrate = B57600);
+    ~RS232Interface();
+    bool init();
+    bool send_frame(const struct can_frame &frame);
+    bool receive_frame(struct can_frame &frame, int timeout_ms = 250);
+
+    bool write(const uint8_t *data, size_t length);
+    void setReceiver(DataHandler handler);
+    std::string port() const { return port_; }
+
+private:
+    void eventLoop();
+    void flushPending();
+    void updateEvents();
+    void stop();
+
+    std::string port_;
+    speed_t baudrate_;
+    int fd_;
+    int epoll_fd_;
+    int wake_fd_;                       // eventfd，用于唤醒事件循环
+    std::vector<uint8_t> tx_pending_;   // 尚未写出的数据
+    bool want_write_;                   // 是否已注册 EPOLLOUT
+    std::mutex tx_mutex_;
+    DataHandler receiver_;
+    std::mutex receiver_mutex_;
+    std::atomic<bool> running_;
+    std::thread loop_thread_;
+};
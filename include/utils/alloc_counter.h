@@ -0,0 +1,43 @@
+/**
+ * @file alloc_counter.h
+ * @brief 堆分配计数
+ * @details 开启 ALLOC_COUNTER_ENABLED 时替换全局 operator new/delete，统计进程内所有线程的分配次数，
+ *          用于确认控制路径在预热后不再访问堆
+ *          - 计数为全局 relaxed 原子量，只加不减，取两次快照之差即区间内的分配次数
+ *          - 未开启时不替换 operator new，enabled() 返回 false，计数恒为0
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace AllocCounter {
+
+struct Snapshot {
+    uint64_t allocations;   // operator new 调用次数
+    uint64_t deallocations; // operator delete 调用次数（不含空指针）
+    uint64_t bytes;         // 累计申请字节数
+};
+
+bool enabled();
+Snapshot snapshot();
+
+} // namespace AllocCounter
+
+/**
+ * @brief 统计作用域内的堆分配
+ * @details 构造时记录快照，allocations() 返回此后全进程的分配次数；
+ *          被测区间之外的线程若同时分配也会计入
+ */
+class AllocScope {
+public:
+    AllocScope() : start_(AllocCounter::snapshot()) {}
+
+    uint64_t allocations() const { return AllocCounter::snapshot().allocations - start_.allocations; }
+    uint64_t deallocations() const { return AllocCounter::snapshot().deallocations - start_.deallocations; }
+    uint64_t bytes() const { return AllocCounter::snapshot().bytes - start_.bytes; }
+
+private:
+    AllocCounter::Snapshot start_;
+};
@@ -0,0 +1,142 @@
+/**
+ * @file broadcast_ring.h
+ * @brief 单生产者多消费者广播环形缓冲
+ * @details 每条数据对所有订阅者可见，订阅者各持游标按自己的节奏读取
+ *          - 生产者从不等待消费者：环满时直接覆盖最旧的数据，写入为定长时间
+ *          - 消费者落后超过容量时跳到仍有效的最旧数据，并在游标中累计丢失条数（溢出检测）
+ *          - 每个槽位带序号，读取方式与 Seqlock 相同，读到一半被覆盖时自动按溢出处理
+ *          - 容量为编译期常量，槽位内联存放，运行中不分配内存
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+template <typename T, size_t Capacity>
+class BroadcastRing {
+    static_assert(std::is_trivially_copyable<T>::value, "BroadcastRing 只能存放可平凡拷贝的类型");
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "BroadcastRing 容量必须是2的幂");
+
+public:
+    // 订阅者游标，由订阅者独占，不可跨线程共享
+    class Cursor {
+    public:
+        uint64_t position() const { return next_; }
+        uint64_t dropped() const { return dropped_; }   // 因落后被覆盖而丢失的条数
+        uint64_t overruns() const { return overruns_; } // 发生溢出的次数
+
+    private:
+        friend class BroadcastRing;
+        explicit Cursor(uint64_t next) : next_(next), dropped_(0), overruns_(0) {}
+
+        uint64_t next_;
+        uint64_t dropped_;
+        uint64_t overruns_;
+    };
+
+    BroadcastRing() : head_(0)
+    {
+        for (auto &slot : slots_)
+        {
+            slot.seq.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    BroadcastRing(const BroadcastRing &) = delete;
+    BroadcastRing &operator=(const BroadcastRing &) = delete;
+
+    /**
+     * @brief 发布一条数据
+     * @note 只允许一个线程调用
+     */
+    void publish(const T &value)
+    {
+        uint64_t pos = head_.load(std::memory_order_relaxed);
+        Slot &slot = slots_[pos & (Capacity - 1)];
+        slot.seq.store(2 * pos + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&slot.data, &value, sizeof(T));
+        slot.seq.store(2 * pos + 2, std::memory_order_release);
+        head_.store(pos + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief 新建订阅，从下一条发布的数据开始读取
+     */
+    Cursor subscribe() const { return Cursor(head_.load(std::memory_order_acquire)); }
+
+    /**
+     * @brief 读取游标处的下一条数据
+     * @param cursor 订阅者游标，落后过多时被前移并记录丢失条数
+     * @param out 读出的数据
+     * @return bool 有新数据返回true，已读到最新返回false
+     */
+    bool read(Cursor &cursor, T &out) const
+    {
+        for (;;)
+        {
+            uint64_t head = head_.load(std::memory_order_acquire);
+            if (cursor.next_ == head)
+            {
+                return false;
+            }
+            if (head - cursor.next_ > Capacity)
+            {
+                skipTo(cursor, head - Capacity);
+            }
+
+            const Slot &slot = slots_[cursor.next_ & (Capacity - 1)];
+            uint64_t expected = 2 * cursor.next_ + 2;
+            uint64_t before = slot.seq.load(std::memory_order_acquire);
+            if (before == expected)
+            {
+                std::memcpy(&out, &slot.data, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                uint64_t after = slot.seq.load(std::memory_order_relaxed);
+                if (after == expected)
+                {
+                    cursor.next_++;
+                    return true;
+                }
+                before = after;
+            }
+            // 槽位已被第 writer 条数据覆盖（或正在覆盖），跳到它之后仍有效的最旧数据
+            uint64_t writer = (before - 1) / 2;
+            skipTo(cursor, writer + 1 - Capacity);
+        }
+    }
+
+    /**
+     * @brief 订阅者尚未读取的条数（可能超过容量，超出部分已丢失）
+     */
+    uint64_t backlog(const Cursor &cursor) const { return head_.load(std::memory_order_acquire) - cursor.next_; }
+
+    // 累计发布条数
+    uint64_t published() const { return head_.load(std::memory_order_acquire); }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq; // 2*pos+1 写入中，2*pos+2 第 pos 条已写完
+        T data;
+    };
+
+    static void skipTo(Cursor &cursor, uint64_t next)
+    {
+        if (next > cursor.next_)
+        {
+            cursor.dropped_ += next - cursor.next_;
+            cursor.overruns_++;
+            cursor.next_ = next;
+        }
+    }
+
+    alignas(64) std::atomic<uint64_t> head_; // 下一条数据的序号，同时是累计发布条数
+    alignas(64) std::array<Slot, Capacity> slots_;
+};
@@ -0,0 +1,104 @@
+/**
+ * @file mpmc_queue.h
+ * @brief 有界无锁多生产者多消费者队列
+ * @details 基于每个槽位序号的环形队列（Vyukov 算法）
+ *          - 入队/出队各只需一次 CAS，不使用互斥锁
+ *          - 容量在构造时确定并向上取整为2的幂，运行中不再分配内存
+ *          - 队列满时 tryPush 立即返回 false，由调用者决定丢弃或重试
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+template <typename T>
+class MPMCQueue {
+public:
+    explicit MPMCQueue(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        cells_ = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; i++) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueuePos_.store(0, std::memory_order_relaxed);
+        dequeuePos_.store(0, std::memory_order_relaxed);
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    template <typename U>
+    bool tryPush(U&& value)
+    {
+        Cell* cell;
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // 队列已满
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = std::forward<U>(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& value)
+    {
+        Cell* cell;
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // 队列为空
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        value = std::move(cell->data);
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return enqueuePos_.load(std::memory_order_acquire) == dequeuePos_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    // 生产者与消费者位置分处不同缓存行，避免伪共享
+    alignas(64) std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> enqueuePos_;
+    alignas(64) std::atomic<size_t> dequeuePos_;
+};
@@ -0,0 +1,30 @@
+/**
+ * @file periodic_deadline.h
+ * @brief 周期截止时间推进
+ * @details ControlLoop 的周期与 PollScheduler 各轮询项的到期时间共用同一推进规则：
+ *          截止时间按周期累加，不受处理耗时与唤醒延迟影响；
+ *          推进后仍不晚于当前时间时按整数个周期跳过积压，保持原有相位，不连续补跑
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief 将截止时间推进到当前时间之后的下一个周期起点
+ * @param deadline_ns 本周期的截止时间，返回时为下一个截止时间
+ * @param period_ns 周期，必须大于0
+ * @param now_ns 当前时间，与 deadline_ns 使用同一时钟
+ * @return uint64_t 被跳过的周期数，未落后时为0
+ */
+inline uint64_t advanceDeadline(int64_t& deadline_ns, int64_t period_ns, int64_t now_ns)
+{
+    deadline_ns += period_ns;
+    if (deadline_ns > now_ns)
+    {
+        return 0;
+    }
+    uint64_t missed = static_cast<uint64_t>((now_ns - deadline_ns) / period_ns) + 1;
+    deadline_ns += static_cast<int64_t>(missed) * period_ns;
+    return missed;
+}
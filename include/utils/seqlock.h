@@ -0,0 +1,68 @@
+/**
+ * @file seqlock.h
+ * @brief 顺序锁（seqlock）模板
+ * @details 适用于写少读多、数据较小且可平凡拷贝的场景
+ *          - 读者不加锁、不阻塞写者，读到一半被写打断时自动重试，保证不会读到撕裂的数据
+ *          - 写者之间通过序号的奇偶位互斥，允许多个写线程
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock 只能保护可平凡拷贝的类型");
+
+public:
+    Seqlock() : seq_(0), data_{} {}
+
+    /**
+     * @brief 原地修改数据
+     * @param f 修改函数，签名为 void(T&)，应尽快返回
+     */
+    template <typename F>
+    void write(F &&f)
+    {
+        uint32_t seq = seq_.load(std::memory_order_relaxed);
+        while ((seq & 1) || !seq_.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            seq = seq_.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        f(data_);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief 读取一份一致的数据拷贝
+     * @return T 数据拷贝
+     */
+    T load() const
+    {
+        T copy;
+        uint32_t before;
+        uint32_t after;
+        do
+        {
+            before = seq_.load(std::memory_order_acquire);
+            std::memcpy(&copy, &data_, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = seq_.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+        return copy;
+    }
+
+    /**
+     * @brief 获取当前序号
+     * @details 每次写入序号加2，可用于判断数据自上次读取后是否更新
+     */
+    uint32_t sequence() const { return seq_.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<uint32_t> seq_;
+    T data_;
+};
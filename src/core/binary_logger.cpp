@@ -0,0 +1,171 @@
+/**
+ * @file binary_logger.cpp
+ * @brief 二进制延迟格式化日志实现文件
+ * @details 后台线程从无锁队列批量取出记录，按需先写出新注册的格式描述，再写出日志记录
+ *          每条记录先拼好再一次写入，保证记录不会跨越两个分段
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "binary_logger.h"
+#include <chrono>
+#include <cstring>
+
+/**
+ * @brief 获取BinaryLogger单例实例
+ * @return BinaryLogger& 单例引用
+ */
+BinaryLogger& BinaryLogger::getInstance() {
+    static BinaryLogger instance;
+    return instance;
+}
+
+BinaryLogger::BinaryLogger()
+    : queue(QUEUE_CAPACITY), siteCount(0), sitesWritten(0),
+      opened(false), writerRunning(false), droppedCount(0) {}
+
+BinaryLogger::~BinaryLogger() {
+    close();
+}
+
+/**
+ * @brief 打开二进制日志文件并启动后台写线程
+ * @details 以滚动分段方式打开，参数与文本日志相同；新分段写入文件头，
+ *          已注册的格式描述会在新分段中重新写出
+ * @param filename 日志文件路径，约定放在 logs/ 下并以 .bin 结尾
+ * @return bool 打开成功返回true
+ */
+bool BinaryLogger::open(const std::string& filename) {
+    close();
+
+    sitesWritten = 0;
+    file.setSegmentCallback([this]() { writeSegmentHeader(); });
+    if (!file.open(filename, LOG_SEGMENT_SIZE, LOG_SEGMENT_COUNT, std::chrono::seconds(LOG_SEGMENT_MAX_AGE_S))) {
+        LOG_ERROR("打开二进制日志文件失败: " + filename);
+        return false;
+    }
+    // 续写已有分段时本进程的格式描述尚未写入
+    sitesWritten = 0;
+
+    writerRunning = true;
+    writerThread = std::thread(&BinaryLogger::writerLoop, this);
+    opened = true;
+    return true;
+}
+
+/**
+ * @brief 停止记录并关闭文件
+ * @details 写完队列中剩余的记录后返回
+ */
+void BinaryLogger::close() {
+    opened = false;
+    writerRunning = false;
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+    file.close();
+}
+
+/**
+ * @brief 注册调用点格式描述
+ * @details 由 BLOG 宏在每个调用点首次执行时调用一次
+ * @param level 日志级别
+ * @param format 格式串，必须具有静态存储期
+ * @return uint32_t 调用点编号，调用点表已满时返回 MAX_SITES，对应的记录不会写出
+ */
+uint32_t BinaryLogger::registerSite(LogLevel level, const char* format) {
+    std::lock_guard<std::mutex> lock(sitesMutex);
+    uint32_t id = siteCount.load(std::memory_order_relaxed);
+    if (id >= MAX_SITES) {
+        return MAX_SITES;
+    }
+    sites[id] = {level, format};
+    siteCount.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+/**
+ * @brief 写出分段文件头
+ * @details 新分段打开时由 RotatingFile 回调，重新写出此前已写过的格式描述，使每个分段可独立解码
+ */
+void BinaryLogger::writeSegmentHeader() {
+    file.write(BLOG_MAGIC, sizeof(BLOG_MAGIC));
+    for (uint32_t id = 0; id < sitesWritten; id++) {
+        writeSite(id);
+    }
+}
+
+/**
+ * @brief 写出一条格式描述
+ * @param id 调用点编号
+ */
+void BinaryLogger::writeSite(uint32_t id) {
+    const Site& site = sites[id];
+    uint16_t length = static_cast<uint16_t>(std::strlen(site.format));
+    std::string buffer(8, '\0');
+    buffer[0] = static_cast<char>(BLOG_RECORD_SITE);
+    std::memcpy(&buffer[1], &id, sizeof(id));
+    buffer[5] = static_cast<char>(site.level);
+    std::memcpy(&buffer[6], &length, sizeof(length));
+    buffer.append(site.format, length);
+    file.write(buffer.data(), buffer.size());
+}
+
+/**
+ * @brief 写出尚未写入当前分段的格式描述
+ */
+void BinaryLogger::writeSites() {
+    uint32_t count = siteCount.load(std::memory_order_acquire);
+    for (; sitesWritten < count; sitesWritten++) {
+        writeSite(sitesWritten);
+    }
+}
+
+/**
+ * @brief 写出一条日志记录
+ * @param record 日志记录
+ */
+void BinaryLogger::writeRecord(const Record& record) {
+    if (record.site >= sitesWritten) {
+        return;
+    }
+    char buffer[1 + sizeof(uint32_t) + sizeof(int64_t) + 1 + sizeof(int64_t) * MAX_ARGS];
+    size_t length = 0;
+    buffer[length++] = static_cast<char>(BLOG_RECORD_LOG);
+    std::memcpy(buffer + length, &record.site, sizeof(record.site));
+    length += sizeof(record.site);
+    std::memcpy(buffer + length, &record.time_ns, sizeof(record.time_ns));
+    length += sizeof(record.time_ns);
+    buffer[length++] = static_cast<char>(record.nargs);
+    std::memcpy(buffer + length, record.args, sizeof(int64_t) * record.nargs);
+    length += sizeof(int64_t) * record.nargs;
+    file.write(buffer, length);
+}
+
+/**
+ * @brief 后台写线程主循环
+ * @details 先取出一批记录再写格式描述，保证记录引用的描述已在其之前写出；每批刷新一次文件
+ */
+void BinaryLogger::writerLoop() {
+    const int batchSize = 512;
+    std::vector<Record> batch;
+    batch.reserve(batchSize);
+    Record record;
+    while (true) {
+        batch.clear();
+        while (static_cast<int>(batch.size()) < batchSize && queue.tryPop(record)) {
+            batch.push_back(record);
+        }
+        if (batch.empty()) {
+            if (!writerRunning.load()) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+        writeSites();
+        for (const auto& r : batch) {
+            writeRecord(r);
+        }
+        file.flush();
+    }
+}
@@ -0,0 +1,258 @@
+/**
+ * @file cascade_controller.cpp
+ * @brief 上位机串级位置/速度控制器实现文件
+ * @details 位置由状态2中的单圈编码器值逐周期展开得到，起点取多圈位置读数（若已读取过），否则为0；
+ *          反馈过期时输出零转矩并清空积分，恢复后从当前状态重新起步
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "cascade_controller.h"
+#include "global_config.h"
+#include <chrono>
+
+static int64_t clamp64(int64_t value, int64_t limit)
+{
+    return value > limit ? limit : (value < -limit ? -limit : value);
+}
+
+/**
+ * @brief CascadeController构造函数
+ * @param device 目标电机，需已连接 CAN 接口
+ * @param gains 控制参数
+ * @param encoderBits 编码器位数（14 或 16）
+ */
+CascadeController::CascadeController(CANDevice& device, const CascadeGains& gains, int encoderBits)
+    : device_(device), encoderRange_(int64_t(1) << encoderBits),
+      staleLimit_ns_(static_cast<int64_t>(CASCADE_FEEDBACK_STALE_MS) * 1000000),
+      mode_(Mode::DISABLED), positionTarget_(0), velocityTarget_(0), resetRequested_(false),
+      lastMode_(Mode::DISABLED), positionState_{0, 0, false}, velocityState_{0, 0, false}, positionValid_(false), lastEncoder_(0),
+      encoderCount_(0), positionOffset_(0), lastFeedback_ns_(0),
+      ticks_(0), staleTicks_(0), sendFailures_(0)
+{
+    setGains(gains);
+    status_.write([](ControlStatus& s) { s = ControlStatus{}; });
+}
+
+void CascadeController::setGains(const CascadeGains& gains)
+{
+    gains_.write([&](CascadeGains& g) { g = gains; });
+}
+
+/**
+ * @brief 切换控制模式
+ * @details 模式改变后控制周期线程在下一周期清空积分；切到 DISABLED 后不再下发命令，电机保持最后的转矩，
+ *          需要时由调用方发送停止命令
+ */
+void CascadeController::setMode(Mode mode)
+{
+    mode_.store(mode, std::memory_order_relaxed);
+}
+
+/**
+ * @brief 设置目标位置，与 ControlStatus::position 同一基准
+ */
+void CascadeController::setPositionTarget(units::CentiDegrees position)
+{
+    positionTarget_.store(position.raw(), std::memory_order_relaxed);
+}
+
+/**
+ * @brief 设置速度模式下的目标转速
+ */
+void CascadeController::setVelocityTarget(units::Dps speed)
+{
+    velocityTarget_.store(speed.raw(), std::memory_order_relaxed);
+}
+
+/**
+ * @brief 请求清空两级环的积分与微分状态
+ * @details 可在任意线程调用，控制周期线程在下一周期执行；清空后第一个周期不产生微分冲击
+ */
+void CascadeController::reset()
+{
+    resetRequested_.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief 定点 PID 单步
+ * @param gains 参数
+ * @param state 运行状态
+ * @param error 误差（输入单位）
+ * @return int32_t 限幅后的输出（输出单位）
+ */
+int32_t CascadeController::update(const PidGains& gains, PidState& state, int32_t error)
+{
+    int64_t integralLimit = static_cast<int64_t>(gains.integralLimit) << CASCADE_Q;
+    state.integral = clamp64(state.integral + static_cast<int64_t>(gains.ki) * error, integralLimit);
+
+    int64_t derivative = state.primed ? static_cast<int64_t>(error) - state.lastError : 0;
+    state.lastError = error;
+    state.primed = true;
+
+    int64_t sum = static_cast<int64_t>(gains.kp) * error + state.integral + static_cast<int64_t>(gains.kd) * derivative;
+    // 四舍五入，避免算术右移向负无穷取整造成正负误差不对称
+    return static_cast<int32_t>(clamp64((sum + (int64_t(1) << (CASCADE_Q - 1))) >> CASCADE_Q, gains.outputLimit));
+}
+
+void CascadeController::resetLoops()
+{
+    positionState_ = PidState{0, 0, false};
+    velocityState_ = PidState{0, 0, false};
+}
+
+static int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief 执行一个控制周期：取快照、运行两级环并下发 iqControl
+ */
+void CascadeController::tick()
+{
+    MotorFrame frame;
+    if (compute(device_.getTelemetry(), steadyNowNs(), frame))
+    {
+        send(frame);
+    }
+}
+
+/**
+ * @brief 下发 compute 生成的命令帧并统计发送失败
+ */
+bool CascadeController::send(const MotorFrame& frame)
+{
+    bool ok = device_.postCommand(frame);
+    if (!ok)
+    {
+        sendFailures_++;
+        status_.write([&](ControlStatus& s) { s.sendFailures = sendFailures_; });
+    }
+    return ok;
+}
+
+/**
+ * @brief 以给定快照运行两级环
+ * @param telemetry 本周期的遥测快照
+ * @param now_ns 本周期时间(steady_clock)，用于判断反馈是否过期
+ * @param frame 输出的转矩命令帧
+ * @return bool 需要下发命令返回true（模式为 DISABLED 时返回false）
+ */
+bool CascadeController::compute(const MotorTelemetry& telemetry, int64_t now_ns, MotorFrame& frame)
+{
+    Mode mode = mode_.load(std::memory_order_relaxed);
+    CascadeGains gains = gains_.load();
+    ticks_++;
+    if (resetRequested_.exchange(false, std::memory_order_relaxed))
+    {
+        resetLoops();
+    }
+
+    // 编码器展开：相邻两次反馈之间转过不足半圈
+    if (telemetry.status2_ns != 0 && telemetry.status2_ns != lastFeedback_ns_)
+    {
+        uint16_t encoder = telemetry.status2.encoder;
+        if (!positionValid_)
+        {
+            encoderCount_ = 0;
+            positionOffset_ = telemetry.multi_position_ns != 0 ? telemetry.multi_position : 0;
+            positionValid_ = true;
+        }
+        else
+        {
+            int64_t delta = static_cast<int64_t>(encoder) - lastEncoder_;
+            if (delta > encoderRange_ / 2)
+            {
+                delta -= encoderRange_;
+            }
+            else if (delta < -encoderRange_ / 2)
+            {
+                delta += encoderRange_;
+            }
+            encoderCount_ += delta;
+        }
+        lastEncoder_ = encoder;
+        lastFeedback_ns_ = telemetry.status2_ns;
+    }
+    int64_t position = positionOffset_ + encoderCount_ * 36000 / encoderRange_;
+    int32_t speed = telemetry.status2.speed;
+
+    if (mode != lastMode_)
+    {
+        resetLoops();
+        lastMode_ = mode;
+    }
+
+    int32_t velocitySetpoint = 0;
+    int16_t iqControl = 0;
+    bool stale = !positionValid_ || now_ns - telemetry.status2_ns > staleLimit_ns_;
+    if (mode != Mode::DISABLED)
+    {
+        if (stale)
+        {
+            // 反馈过期：零转矩并清空积分，同时继续下发命令以取得新的状态2响应
+            resetLoops();
+            staleTicks_++;
+        }
+        else
+        {
+            if (mode == Mode::POSITION)
+            {
+                int64_t error = clamp64(positionTarget_.load(std::memory_order_relaxed) - position, INT32_MAX);
+                velocitySetpoint = update(gains.position, positionState_, static_cast<int32_t>(error));
+            }
+            else
+            {
+                velocitySetpoint = velocityTarget_.load(std::memory_order_relaxed);
+            }
+            int32_t iq = update(gains.velocity, velocityState_, velocitySetpoint - speed);
+            iqControl = static_cast<int16_t>(clamp64(iq, 2048));
+        }
+        frame = MotorCodec::TorqueControl::encode(iqControl);
+    }
+
+    status_.write([&](ControlStatus& s) {
+        s.position = position;
+        s.speed = speed;
+        s.velocitySetpoint = velocitySetpoint;
+        s.iqControl = iqControl;
+        s.ticks = ticks_;
+        s.staleTicks = staleTicks_;
+        s.sendFailures = sendFailures_;
+    });
+    return mode != Mode::DISABLED;
+}
+
+/**
+ * @brief TrackPairController构造函数
+ * @param left 左侧电机
+ * @param right 右侧电机
+ * @param gains 两侧共用的初始控制参数，之后可分别修改
+ * @param encoderBits 编码器位数
+ */
+TrackPairController::TrackPairController(CANDevice& left, CANDevice& right, const CascadeGains& gains, int encoderBits)
+    : left_(left, gains, encoderBits), right_(right, gains, encoderBits) {}
+
+/**
+ * @brief 执行一个控制周期：同时取两侧快照，算完两侧输出后连续下发
+ */
+void TrackPairController::tick()
+{
+    MotorTelemetry leftTelemetry = left_.device().getTelemetry();
+    MotorTelemetry rightTelemetry = right_.device().getTelemetry();
+    int64_t now_ns = steadyNowNs();
+
+    MotorFrame leftFrame;
+    MotorFrame rightFrame;
+    bool sendLeft = left_.compute(leftTelemetry, now_ns, leftFrame);
+    bool sendRight = right_.compute(rightTelemetry, now_ns, rightFrame);
+    if (sendLeft)
+    {
+        left_.send(leftFrame);
+    }
+    if (sendRight)
+    {
+        right_.send(rightFrame);
+    }
+}
@@ -0,0 +1,269 @@
+/**
+ * @file command_scheduler.cpp
+ * @brief 定时命令批次调度器实现文件
+ * @details 帧在 schedule() 时已构造完成，截止时刻只剩连续的 write 调用；
+ *          skew 为首帧与末帧提交给内核的时刻之差，总线上的实际间隔另加每帧的传输时间
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "command_scheduler.h"
+#include "global_config.h"
+#include "logger.h"
+#include <chrono>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+
+/**
+ * @brief 向批次追加一条命令，立即构造帧
+ * @param device 目标设备，需已设置 CAN 接口
+ * @param command 命令
+ * @param data 附加数据（可选），7字节，data[i-1] 对应帧 data[i]
+ * @return bool 设备未设置接口时返回false
+ */
+bool CommandBatch::add(CANDevice& device, uint8_t command, const uint8_t* data)
+{
+    if (!device.getInterface())
+    {
+        LOG_ERROR("设备 " + device.getId() + " 未设置 CAN 接口，无法加入命令批次");
+        return false;
+    }
+    Entry entry;
+    entry.interface = device.getInterface();
+    device.buildFrame(command, data, entry.frame);
+    frames_.push_back(entry);
+    return true;
+}
+
+/**
+ * @brief CommandScheduler构造函数
+ * @param priority 调度线程的 SCHED_FIFO 优先级，0 表示普通调度
+ */
+CommandScheduler::CommandScheduler(int priority)
+    : priority_(priority), nextId_(1), running_(false) {}
+
+CommandScheduler::~CommandScheduler()
+{
+    stop();
+}
+
+int64_t CommandScheduler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool CommandScheduler::start()
+{
+    if (running_.exchange(true))
+    {
+        return true;
+    }
+    thread_ = std::thread(&CommandScheduler::run, this);
+    return true;
+}
+
+/**
+ * @brief 停止调度线程，未到期的批次以取消结果完成
+ */
+void CommandScheduler::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!pending_.empty())
+    {
+        auto it = pending_.begin();
+        BatchResult result{it->second.id, it->first, 0, 0, 0, 0, 0, it->second.batch.size(), true};
+        Callback callback = std::move(it->second.callback);
+        pending_.erase(it);
+        lock.unlock();
+        complete(result, callback);
+        lock.lock();
+    }
+}
+
+/**
+ * @brief 预约一个批次在指定时刻发出
+ * @param batch 命令批次（拷贝）
+ * @param deadline_ns 发出时刻，steady_clock 纳秒（见 now()）
+ * @param callback 完成回调（可选），在调度线程中调用，不应阻塞
+ * @return uint64_t 批次编号，失败返回0
+ */
+uint64_t CommandScheduler::schedule(const CommandBatch& batch, int64_t deadline_ns, Callback callback)
+{
+    if (batch.empty())
+    {
+        return 0;
+    }
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_)
+        {
+            LOG_ERROR("命令调度器未启动");
+            return 0;
+        }
+        id = nextId_++;
+        pending_.emplace(deadline_ns, Pending{id, batch, std::move(callback)});
+    }
+    cv_.notify_all();
+    return id;
+}
+
+uint64_t CommandScheduler::scheduleIn(const CommandBatch& batch, uint32_t delay_ms, Callback callback)
+{
+    return schedule(batch, now() + static_cast<int64_t>(delay_ms) * 1000000, std::move(callback));
+}
+
+/**
+ * @brief 取消尚未到期的批次
+ * @return bool 批次已发出或不存在时返回false
+ */
+bool CommandScheduler::cancel(uint64_t id)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto it = pending_.begin(); it != pending_.end(); ++it)
+    {
+        if (it->second.id == id)
+        {
+            BatchResult result{id, it->first, 0, 0, 0, 0, 0, it->second.batch.size(), true};
+            Callback callback = std::move(it->second.callback);
+            pending_.erase(it);
+            lock.unlock();
+            cv_.notify_all();
+            complete(result, callback);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 等待批次完成
+ * @param id 批次编号
+ * @param result 输出执行结果
+ * @param timeout_ms 超时时间(毫秒)
+ * @return bool 批次在超时前完成（含被取消）返回true
+ */
+bool CommandScheduler::wait(uint64_t id, BatchResult& result, uint32_t timeout_ms)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto find = [&]() {
+        for (const auto& r : results_)
+        {
+            if (r.id == id)
+            {
+                result = r;
+                return true;
+            }
+        }
+        return false;
+    };
+    return doneCv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), find);
+}
+
+void CommandScheduler::complete(const BatchResult& result, const Callback& callback)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        results_.push_back(result);
+        while (results_.size() > COMMAND_SCHEDULE_HISTORY)
+        {
+            results_.pop_front();
+        }
+    }
+    doneCv_.notify_all();
+    if (callback)
+    {
+        callback(result);
+    }
+}
+
+/**
+ * @brief 在截止时刻连续写出批次中的全部帧
+ */
+CommandScheduler::BatchResult CommandScheduler::emit(const Pending& pending, int64_t deadline_ns)
+{
+    // 最后一段忙等，避免定时器唤醒延迟
+    while (now() < deadline_ns)
+    {
+    }
+
+    BatchResult result{pending.id, deadline_ns, 0, 0, 0, 0, 0, pending.batch.size(), false};
+    for (size_t i = 0; i < pending.batch.frames_.size(); i++)
+    {
+        const auto& entry = pending.batch.frames_[i];
+        int64_t t = now();
+        if (i == 0)
+        {
+            result.first_ns = t;
+        }
+        result.last_ns = t;
+        if (entry.interface->send_frame(entry.frame))
+        {
+            result.sent++;
+        }
+    }
+    result.lateness_ns = result.first_ns - deadline_ns;
+    result.skew_ns = result.last_ns - result.first_ns;
+    return result;
+}
+
+// 调度循环
+void CommandScheduler::run()
+{
+    if (priority_ > 0)
+    {
+        struct sched_param param;
+        param.sched_priority = priority_;
+        int ret = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (ret != 0)
+        {
+            LOG_WARNING("命令调度线程切换到 SCHED_FIFO 失败，以普通调度运行: " + std::string(std::strerror(ret)));
+        }
+    }
+
+    const int64_t spin_ns = static_cast<int64_t>(COMMAND_SCHEDULE_SPIN_US) * 1000;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_)
+    {
+        if (pending_.empty())
+        {
+            cv_.wait(lock);
+            continue;
+        }
+        int64_t deadline = pending_.begin()->first;
+        int64_t wake = deadline - spin_ns;
+        if (now() < wake)
+        {
+            // 新的更早批次或取消会唤醒并重新计算
+            cv_.wait_until(lock, std::chrono::steady_clock::time_point(std::chrono::nanoseconds(wake)));
+            continue;
+        }
+
+        auto it = pending_.begin();
+        Pending pending = std::move(it->second);
+        pending_.erase(it);
+        lock.unlock();
+
+        BatchResult result = emit(pending, deadline);
+        if (result.sent != result.count)
+        {
+            LOG_ERROR("命令批次 " + std::to_string(result.id) + " 发送不完整: " +
+                      std::to_string(result.sent) + "/" + std::to_string(result.count));
+        }
+        LOG_DEBUG("命令批次 " + std::to_string(result.id) + " 已发出，延迟 " + std::to_string(result.lateness_ns / 1000) +
+                  " us，首末帧偏差 " + std::to_string(result.skew_ns / 1000) + " us");
+        complete(result, pending.callback);
+        lock.lock();
+    }
+}
@@ -0,0 +1,303 @@
+/**
+ * @file control_loop.cpp
+ * @brief 实时周期控制循环执行器实现文件
+ * @details 周期起点按绝对时间累加，不受任务耗时与唤醒延迟影响；
+ *          任务执行超过一个周期时跳过已错过的周期，不连续补跑
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "control_loop.h"
+#include "logger.h"
+#include "periodic_deadline.h"
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+static int64_t monotonicNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+static struct timespec toTimespec(int64_t ns)
+{
+    struct timespec ts;
+    ts.tv_sec = ns / 1000000000LL;
+    ts.tv_nsec = ns % 1000000000LL;
+    return ts;
+}
+
+// 预触碰栈：让栈页在进入循环前全部分配并被 mlockall 锁定
+// 经 volatile 指针逐页写一个字节，编译器不能省略这些写入
+static void __attribute__((noinline)) prefaultStack()
+{
+    uint8_t stack[CONTROL_LOOP_PREFAULT_STACK];
+    volatile uint8_t *touch = stack;
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    for (size_t offset = 0; offset < sizeof(stack); offset += page)
+    {
+        touch[offset] = 0;
+    }
+    touch[sizeof(stack) - 1] = 0;
+}
+
+/**
+ * @brief ControlLoop构造函数
+ * @param options 实时参数
+ */
+ControlLoop::ControlLoop(const Options& options)
+    : options_(options), running_(false), cycles_(0), overruns_(0), missedPeriods_(0),
+      maxLatency_ns_(0), sumLatency_ns_(0), maxExecution_ns_(0), realtime_(false)
+{
+    for (auto& bucket : latencyHistogram_)
+    {
+        bucket = 0;
+    }
+    for (auto& bucket : overrunHistogram_)
+    {
+        bucket = 0;
+    }
+}
+
+ControlLoop::~ControlLoop()
+{
+    stop();
+}
+
+/**
+ * @brief 注册周期任务
+ * @details 任务按注册顺序在同一周期内依次执行，只能在 start() 之前注册
+ * @param name 任务名称
+ * @param task 任务函数，不应阻塞或分配内存
+ * @param divider 分频系数，每 divider 个周期执行一次
+ * @return bool 注册成功返回true
+ */
+bool ControlLoop::addTask(const std::string& name, Task task, uint32_t divider)
+{
+    if (running_)
+    {
+        LOG_ERROR("控制循环运行中，不能注册任务: " + name);
+        return false;
+    }
+    if (!task || divider == 0)
+    {
+        LOG_ERROR("无效的控制循环任务: " + name);
+        return false;
+    }
+    tasks_.push_back({name, std::move(task), divider});
+    return true;
+}
+
+bool ControlLoop::start()
+{
+    if (options_.period_ns <= 0)
+    {
+        LOG_ERROR("控制循环周期无效: " + std::to_string(options_.period_ns));
+        return false;
+    }
+    if (running_.exchange(true))
+    {
+        return true;
+    }
+    thread_ = std::thread(&ControlLoop::run, this);
+    return true;
+}
+
+void ControlLoop::stop()
+{
+    running_ = false;
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+}
+
+/**
+ * @brief 在循环线程内设置实时属性
+ * @details 各项设置失败只记录警告，循环仍以普通线程运行
+ */
+void ControlLoop::setupThread()
+{
+    if (options_.lockMemory)
+    {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        {
+            LOG_WARNING("mlockall 失败: " + std::string(std::strerror(errno)));
+        }
+        prefaultStack();
+    }
+
+    if (options_.cpu >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(options_.cpu, &set);
+        int ret = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (ret != 0)
+        {
+            LOG_WARNING("控制循环绑定 CPU " + std::to_string(options_.cpu) + " 失败: " + std::strerror(ret));
+        }
+    }
+
+    if (options_.priority > 0)
+    {
+        struct sched_param param;
+        param.sched_priority = options_.priority;
+        int ret = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (ret != 0)
+        {
+            LOG_WARNING("控制循环切换到 SCHED_FIFO 失败，以普通调度运行: " + std::string(std::strerror(ret)));
+        }
+        realtime_ = ret == 0;
+    }
+}
+
+// 周期循环
+void ControlLoop::run()
+{
+    setupThread();
+    LOG_INFO("控制循环启动，周期 " + std::to_string(options_.period_ns / 1000) + " us，任务数 " +
+             std::to_string(tasks_.size()) + (realtime_ ? "，SCHED_FIFO 优先级 " + std::to_string(options_.priority) : "，普通调度"));
+
+    const int64_t period = options_.period_ns;
+    int64_t deadline = monotonicNs() + period;
+    uint64_t cycle = 0;
+    while (running_)
+    {
+        struct timespec ts = toTimespec(deadline);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+        {
+        }
+
+        int64_t wake = monotonicNs();
+        recordLatency(wake - deadline);
+
+        for (const auto& entry : tasks_)
+        {
+            if (cycle % entry.divider == 0)
+            {
+                entry.task(deadline);
+            }
+        }
+
+        int64_t end = monotonicNs();
+        int64_t execution = end - wake;
+        if (execution > maxExecution_ns_.load(std::memory_order_relaxed))
+        {
+            maxExecution_ns_.store(execution, std::memory_order_relaxed);
+        }
+        cycles_.fetch_add(1, std::memory_order_relaxed);
+        cycle++;
+
+        // 已越过下一周期起点：跳过错过的周期，分频计数同步推进以保持任务相位
+        uint64_t missed = advanceDeadline(deadline, period, end);
+        if (missed > 0)
+        {
+            cycle += missed;
+            recordOverrun(missed);
+        }
+    }
+    LOG_INFO("控制循环停止。" + formatStats());
+}
+
+void ControlLoop::recordLatency(int64_t latency_ns)
+{
+    if (latency_ns < 0)
+    {
+        latency_ns = 0;
+    }
+    size_t bucket = static_cast<size_t>(latency_ns / (CONTROL_LOOP_JITTER_BUCKET_US * 1000LL));
+    if (bucket >= latencyHistogram_.size())
+    {
+        bucket = latencyHistogram_.size() - 1;
+    }
+    latencyHistogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+    sumLatency_ns_.fetch_add(latency_ns, std::memory_order_relaxed);
+    if (latency_ns > maxLatency_ns_.load(std::memory_order_relaxed))
+    {
+        maxLatency_ns_.store(latency_ns, std::memory_order_relaxed);
+    }
+}
+
+void ControlLoop::recordOverrun(uint64_t missed)
+{
+    size_t bucket = static_cast<size_t>(missed - 1);
+    if (bucket >= overrunHistogram_.size())
+    {
+        bucket = overrunHistogram_.size() - 1;
+    }
+    overrunHistogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+    overruns_.fetch_add(1, std::memory_order_relaxed);
+    missedPeriods_.fetch_add(missed, std::memory_order_relaxed);
+}
+
+ControlLoop::LoopStats ControlLoop::getStats() const
+{
+    LoopStats stats;
+    stats.cycles = cycles_.load(std::memory_order_relaxed);
+    stats.overruns = overruns_.load(std::memory_order_relaxed);
+    stats.missedPeriods = missedPeriods_.load(std::memory_order_relaxed);
+    stats.maxLatency_ns = maxLatency_ns_.load(std::memory_order_relaxed);
+    stats.meanLatency_ns = stats.cycles ? sumLatency_ns_.load(std::memory_order_relaxed) / static_cast<int64_t>(stats.cycles) : 0;
+    stats.maxExecution_ns = maxExecution_ns_.load(std::memory_order_relaxed);
+    stats.realtime = realtime_;
+    for (size_t i = 0; i < latencyHistogram_.size(); i++)
+    {
+        stats.latencyHistogram[i] = latencyHistogram_[i].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < overrunHistogram_.size(); i++)
+    {
+        stats.overrunHistogram[i] = overrunHistogram_[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+/**
+ * @brief 清零统计，例如在启动阶段结束后开始正式计量
+ * @note 与循环线程并发清零时，个别周期可能只被部分计入
+ */
+void ControlLoop::resetStats()
+{
+    cycles_ = 0;
+    overruns_ = 0;
+    missedPeriods_ = 0;
+    maxLatency_ns_ = 0;
+    sumLatency_ns_ = 0;
+    maxExecution_ns_ = 0;
+    for (auto& bucket : latencyHistogram_)
+    {
+        bucket = 0;
+    }
+    for (auto& bucket : overrunHistogram_)
+    {
+        bucket = 0;
+    }
+}
+
+/**
+ * @brief 统计信息的单行文本，直方图只列出非空桶
+ */
+std::string ControlLoop::formatStats() const
+{
+    LoopStats stats = getStats();
+    std::string text = "周期数 " + std::to_string(stats.cycles) +
+                       " 超时 " + std::to_string(stats.overruns) + " (跳过 " + std::to_string(stats.missedPeriods) + " 周期)" +
+                       " 唤醒延迟 平均 " + std::to_string(stats.meanLatency_ns / 1000) + " us 最大 " + std::to_string(stats.maxLatency_ns / 1000) + " us" +
+                       " 执行最长 " + std::to_string(stats.maxExecution_ns / 1000) + " us 延迟分布:";
+    for (size_t i = 0; i < stats.latencyHistogram.size(); i++)
+    {
+        if (stats.latencyHistogram[i])
+        {
+            bool last = i + 1 == stats.latencyHistogram.size();
+            text += (last ? " >=" + std::to_string(i * CONTROL_LOOP_JITTER_BUCKET_US)
+                          : " <" + std::to_string((i + 1) * CONTROL_LOOP_JITTER_BUCKET_US)) +
+                    "us:" + std::to_string(stats.latencyHistogram[i]);
+        }
+    }
+    return text;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file device_event_bus.cpp
+ * @brief 设备事件总线实现文件
+ * @details 投递方入队后通知分发线程；分发线程另以 DEVICE_EVENT_POLL_MS 为周期检查队列，
+ *          通知在检查与等待之间丢失时最多延迟一个周期
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "device_event_bus.h"
+#include "global_config.h"
+#include <algorithm>
+
+static int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+DeviceEventBus& DeviceEventBus::getInstance()
+{
+    static DeviceEventBus instance;
+    return instance;
+}
+
+DeviceEventBus::DeviceEventBus()
+    : queue_(DEVICE_EVENT_QUEUE_CAPACITY), nextId_(1), running_(false), dropped_(0), delivered_(0) {}
+
+DeviceEventBus::~DeviceEventBus()
+{
+    stop();
+}
+
+/**
+ * @brief 启动分发线程，重复调用无效
+ */
+void DeviceEventBus::start()
+{
+    if (running_.exchange(true))
+    {
+        return;
+    }
+    thread_ = std::thread(&DeviceEventBus::dispatchLoop, this);
+}
+
+/**
+ * @brief 分发完队列中剩余的事件后停止分发线程
+ */
+void DeviceEventBus::stop()
+{
+    if (!running_.exchange(false))
+    {
+        return;
+    }
+    wakeCv_.notify_one();
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+}
+
+/**
+ * @brief 投递事件
+ * @details 只入队并通知分发线程，不等待订阅者；分发线程未启动时事件在队列中等待
+ * @param event 事件，时间戳为0时填入当前时间
+ * @return bool 队列已满被丢弃返回false
+ */
+bool DeviceEventBus::post(DeviceEvent event)
+{
+    if (event.timestamp_ns == 0)
+    {
+        event.timestamp_ns = steadyNowNs();
+    }
+    if (!queue_.tryPush(std::move(event)))
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    wakeCv_.notify_one();
+    return true;
+}
+
+bool DeviceEventBus::postStatus(const std::string& deviceId, DeviceStatus status)
+{
+    return post(DeviceEvent{DeviceEventType::STATUS_CHANGED, deviceId, status, 0, 0, 0, 0});
+}
+
+bool DeviceEventBus::postTimeout(const std::string& deviceId, uint8_t command)
+{
+    return post(DeviceEvent{DeviceEventType::TIMEOUT, deviceId, DeviceStatus::DISCONNECTED, command, 0, 0, 0});
+}
+
+bool DeviceEventBus::postErrorFlags(const std::string& deviceId, uint8_t errorState, uint8_t previousErrorState)
+{
+    return post(DeviceEvent{DeviceEventType::ERROR_FLAGS, deviceId, DeviceStatus::DISCONNECTED, 0,
+                            errorState, previousErrorState, 0});
+}
+
+/**
+ * @brief 注册订阅者
+ * @param filter 过滤条件
+ * @param handler 回调，在分发线程中执行
+ * @return uint64_t 订阅ID，用于取消订阅
+ */
+uint64_t DeviceEventBus::subscribe(const DeviceEventFilter& filter, Handler handler)
+{
+    std::lock_guard<std::mutex> lock(subscribersMutex_);
+    uint64_t id = nextId_++;
+    subscribers_.push_back(Subscriber{id, filter, std::make_shared<Handler>(std::move(handler))});
+    return id;
+}
+
+/**
+ * @brief 取消订阅
+ * @details 在分发线程之外调用时等待正在进行的分发结束，返回后回调不会再被调用；
+ *          在回调中调用时立即生效于后续事件
+ * @param id 订阅ID
+ */
+void DeviceEventBus::unsubscribe(uint64_t id)
+{
+    std::unique_lock<std::mutex> dispatching(dispatchMutex_, std::defer_lock);
+    if (std::this_thread::get_id() != thread_.get_id())
+    {
+        dispatching.lock();
+    }
+    std::lock_guard<std::mutex> lock(subscribersMutex_);
+    subscribers_.erase(std::remove_if(subscribers_.begin(), subscribers_.end(),
+                                      [id](const Subscriber& s) { return s.id == id; }),
+                       subscribers_.end());
+}
+
+/**
+ * @brief 分发线程主循环
+ */
+void DeviceEventBus::dispatchLoop()
+{
+    DeviceEvent event;
+    while (true)
+    {
+        bool any = false;
+        while (queue_.tryPop(event))
+        {
+            dispatch(event);
+            any = true;
+        }
+        if (any)
+        {
+            continue;
+        }
+        if (!running_.load(std::memory_order_acquire))
+        {
+            break;
+        }
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wakeCv_.wait_for(lock, std::chrono::milliseconds(DEVICE_EVENT_POLL_MS));
+    }
+}
+
+/**
+ * @brief 将一条事件交给匹配的订阅者
+ * @details 先在锁内复制匹配的回调，再逐个调用，回调中可以订阅或取消订阅
+ */
+void DeviceEventBus::dispatch(const DeviceEvent& event)
+{
+    std::lock_guard<std::mutex> dispatching(dispatchMutex_);
+    std::vector<std::shared_ptr<Handler>> matched;
+    {
+        std::lock_guard<std::mutex> lock(subscribersMutex_);
+        for (const auto& subscriber : subscribers_)
+        {
+            if (subscriber.filter.matches(event))
+            {
+                matched.push_back(subscriber.handler);
+            }
+        }
+    }
+    for (const auto& handler : matched)
+    {
+        (*handler)(event);
+        delivered_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
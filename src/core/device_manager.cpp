@@ -2,50 +2,165 @@
  * @file device_manager.cpp
  * @brief 设备管理器实现文件
  * @details 提供设备的统一管理功能，包括设备的添加、删除、连接控制和命令发送
- *          支持多种设备协议（CAN、RS232），使用工厂模式创建设备实例
+ *          内置协议（CAN、RS232）的设备存放在 variant 中静态分发，其它协议经工厂创建并走虚接口
  * @author zakiu
  * @date 2025-07-15
  */
 
 #include "device_manager.h"
+#include "binary_logger.h"
+#include <cstdio>
 #include <regex>
 
 /**
  * @brief DeviceManager构造函数
- * @details 初始化设备管理器，注册支持的设备协议
- *          - 注册CAN设备创建函数
- *          - 注册RS232设备创建函数
- *          使用工厂模式实现设备的统一创建
+ * @details 内置协议（CAN、RS232）由 BuiltinDevices 在编译期注册，设备直接存放在容器节点中；
+ *          其它协议需预先在 DeviceFactory 中注册，以插件形式经虚接口访问。
+ *          同时启动设备事件总线，状态变化与错误标志的日志由总线分发线程输出
  */
 DeviceManager::DeviceManager() {
-    DeviceFactory::getInstance().registerProtocol("CAN", 
-        [](const std::string& id) -> std::unique_ptr<Device> {
-            return std::make_unique<CANDevice>(id);
-        });
-    
-    DeviceFactory::getInstance().registerProtocol("RS232", 
-        [](const std::string& id) -> std::unique_ptr<Device> {
-            return std::make_unique<RS232Device>(id);
-        });
+    DeviceEventBus& bus = DeviceEventBus::getInstance();
+    bus.start();
+    DeviceEventFilter filter;
+    filter.typeMask = eventMask(DeviceEventType::STATUS_CHANGED) | eventMask(DeviceEventType::ERROR_FLAGS);
+    logSubscription = bus.subscribe(filter, [this](const DeviceEvent& event) { logDeviceEvent(event); });
+    setAutoClearError(DEVICE_AUTO_CLEAR_ERROR);
+}
+
+/**
+ * @brief DeviceManager析构函数
+ * @details 取消事件订阅，返回后总线不再回调本对象
+ */
+DeviceManager::~DeviceManager() {
+    setAutoClearError(false);
+    DeviceEventBus::getInstance().unsubscribe(logSubscription);
+}
+
+/**
+ * @brief 开关错误标志自动清除
+ * @details 开启后订阅电机错误标志事件，标志由0变为非0时在事件总线线程中下发清除错误命令；
+ *          清除后故障仍在时标志不变，不会产生新事件，因此不会反复下发
+ * @param enable 是否开启
+ */
+void DeviceManager::setAutoClearError(bool enable) {
+    DeviceEventBus& bus = DeviceEventBus::getInstance();
+    if (enable) {
+        DeviceEventFilter filter;
+        filter.typeMask = eventMask(DeviceEventType::ERROR_FLAGS);
+        uint64_t id = bus.subscribe(filter, [this](const DeviceEvent& event) { clearMotorError(event); });
+        uint64_t previous = clearErrorSubscription.exchange(id);
+        if (previous) {
+            bus.unsubscribe(previous);
+        }
+    } else {
+        uint64_t previous = clearErrorSubscription.exchange(0);
+        if (previous) {
+            bus.unsubscribe(previous);
+        }
+    }
+}
+
+/**
+ * @brief 事件总线回调：下发清除错误命令
+ * @details 在事件总线线程中执行，等待响应不影响收发与心跳线程
+ */
+void DeviceManager::clearMotorError(const DeviceEvent& event) {
+    if (event.errorState == 0 || event.previousErrorState != 0) {
+        return;
+    }
+    auto frame = MotorCodec::ClearError::encode();
+    LOG_WARNING("设备 [" + event.deviceId + "] 上报错误标志，自动清除错误");
+    if (!sendCommand(event.deviceId, frame[0], frame.data() + 1)) {
+        LOG_ERROR("设备 [" + event.deviceId + "] 清除错误命令未得到响应");
+    }
+}
+
+/**
+ * @brief 检查设备ID格式
+ * @param id 设备唯一标识符
+ * @return bool 符合 "<device_name>_<number>" 格式返回true
+ */
+bool DeviceManager::validateId(const std::string& id) const {
+    static const std::regex idPattern("^[a-zA-Z]+_\\d+$");
+    if (!std::regex_match(id, idPattern)) {
+        LOG_WARNING("设备id [" + id + "] 格式无效，请使用: <device_name>_<number>");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 设置设备状态变化回调
+ * @param device 新加入的设备
+ */
+void DeviceManager::attachStatusCallback(Device& device) {
+    device.setStatusCallback([this](const std::string& id, DeviceStatus status) {
+        handleDeviceStatusChange(id, status);
+    });
+}
+
+/**
+ * @brief 为新设备分配句柄表项
+ * @details CAN 电机同时以表项下标作为其在 TelemetryStore 中的行
+ * @param slot 新设备所在槽
+ * @return bool 句柄表已满返回false
+ * @note 调用者需持有 devicesMutex，并在设置设备接口之前调用
+ */
+bool DeviceManager::bindHandle(DeviceSlot* slot) {
+    for (size_t i = 0; i < handles.size(); i++) {
+        if (!handles[i].slot) {
+            handles[i].slot = slot;
+            if (CANDevice* motor = std::get_if<CANDevice>(slot)) {
+                motor->setTelemetrySlot(static_cast<int>(i));
+            }
+            return true;
+        }
+    }
+    LOG_ERROR("设备数量已达上限 " + std::to_string(DEVICE_MAX_HANDLES));
+    return false;
+}
+
+/**
+ * @brief 释放设备的句柄表项，代数递增使旧句柄失效
+ * @note 调用者需持有 devicesMutex
+ */
+void DeviceManager::releaseHandle(const DeviceSlot* slot) {
+    for (auto& entry : handles) {
+        if (entry.slot == slot) {
+            entry.slot = nullptr;
+            entry.generation = entry.generation == 0xFFFF ? 1 : entry.generation + 1;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 句柄解析为设备槽
+ * @return DeviceSlot* 句柄无效或设备已移除返回nullptr
+ * @note 调用者需持有 devicesMutex
+ */
+DeviceSlot* DeviceManager::lookup(DeviceHandle handle) const {
+    uint32_t index = (handle.value & 0xFFFF) - 1;
+    if (index >= handles.size()) {
+        return nullptr;
+    }
+    const HandleEntry& entry = handles[index];
+    return entry.generation == (handle.value >> 16) ? entry.slot : nullptr;
 }
 
 /**
  * @brief 添加新设备到管理器
  * @details 线程安全地添加设备实例到设备管理器
  *          - 检查设备ID是否已存在
- *          - 使用工厂模式创建对应协议的设备
- *          - 设置设备状态变化回调函数
- *          - 将设备添加到管理容器中
+ *          - 内置协议在容器中原地构造具体设备，其它协议使用工厂创建插件设备
+ *          - 设置设备状态变化回调函数和设备接口
  * @param protocol 设备协议类型（如"CAN"、"RS232"）
  * @param id 设备唯一标识符
  * @param interface 设备接口引用
  * @return bool 添加成功返回true，失败返回false
  */
 bool DeviceManager::addDevice(const std::string& protocol, const std::string& id, Interface& interface) {
-    // 检查 id 是否符合 "device_<number>" 格式
-    std::regex idPattern("^[a-zA-Z]+_\\d+$");
-    if (!std::regex_match(id, idPattern)) {
-        LOG_WARNING("设备id [" + id + "] 格式无效，请使用: <device_name>_<number>");
+    if (!validateId(id)) {
         return false;
     }
 
@@ -55,17 +170,24 @@ bool DeviceManager::addDevice(const std::string& protocol, const std::string& id
         return false;
     }
 
-    auto device = DeviceFactory::getInstance().createDevice(protocol, id);
-    if (!device) {
-        LOG_ERROR("创建设备失败: [" + id + "]");
+    DeviceSlot* slot = emplaceBuiltin(protocol, id, BuiltinDevices{});
+    if (!slot) {
+        auto device = DeviceFactory::getInstance().createDevice(protocol, id);
+        if (!device) {
+            LOG_ERROR("创建设备失败: [" + id + "]");
+            return false;
+        }
+        slot = &devices.emplace(id, std::move(device)).first->second;
+    }
+    if (!bindHandle(slot)) {
+        devices.erase(id);
         return false;
     }
 
-    device->setStatusCallback([this](const std::string& id, DeviceStatus status) {
-        handleDeviceStatusChange(id, status);
+    visitDevice(*slot, [this, &interface](auto& device) {
+        attachStatusCallback(device);
+        device.setInterface(interface); // 设置设备接口
     });
-    devices[id] = std::move(device);
-    devices[id]->setInterface(interface); // 设置设备接口
     LOG_INFO("已添加设备: [" + id + "] (" + protocol + ")");
     return true;
 }
@@ -86,7 +208,8 @@ bool DeviceManager::removeDevice(const std::string& id) {
         LOG_WARNING("设备未找到: [" + id + "]");
         return false;
     }
-    it->second->disconnect();
+    visitDevice(it->second, [](auto& device) { return device.disconnect(); });
+    releaseHandle(&it->second);
     devices.erase(it);
     LOG_INFO("已移除设备: [" + id + "]");
     return true;
@@ -107,7 +230,7 @@ bool DeviceManager::connectDevice(const std::string& id) {
         LOG_WARNING("设备未找到: [" + id + "]");
         return false;
     }
-    return it->second->connect();
+    return visitDevice(it->second, [](auto& device) { return device.connect(); });
 }
 
 /**
@@ -125,7 +248,7 @@ bool DeviceManager::disconnectDevice(const std::string& id) {
         LOG_WARNING("设备未找到: [" + id + "]");
         return false;
     }
-    return it->second->disconnect();
+    return visitDevice(it->second, [](auto& device) { return device.disconnect(); });
 }
 
 /**
@@ -144,7 +267,7 @@ bool DeviceManager::sendCommand(const std::string& id, uint8_t command, const ui
         LOG_WARNING("设备未找到: [" + id + "]");
         return false;
     }
-    return it->second->sendCommand(command, data);
+    return visitDevice(it->second, [command, data](auto& device) { return device.sendCommand(command, data); });
 }
 
 /**
@@ -179,22 +302,108 @@ DeviceStatus DeviceManager::getDeviceStatus(const std::string& id) const {
     if (it == devices.end()) {
         return DeviceStatus::DISCONNECTED;
     }
-    return it->second->getStatus();
+    return visitDevice(it->second, [](const auto& device) { return device.getStatus(); });
+}
+
+/**
+ * @brief 获取指定设备实例
+ * @details 通过虚接口访问设备；已知设备类型时使用 getDeviceAs<T>() 免去类型转换
+ * @param id 设备唯一标识符
+ * @return Device* 设备指针，设备不存在返回nullptr
+ * @note 返回的指针在设备被移除后失效
+ */
+Device* DeviceManager::getDevice(const std::string& id) {
+    std::lock_guard<std::mutex> lock(devicesMutex);
+    auto it = devices.find(id);
+    if (it == devices.end()) {
+        return nullptr;
+    }
+    return visitDevice(it->second, [](Device& device) { return &device; });
+}
+
+/**
+ * @brief 获取设备句柄
+ * @details 在初始化阶段调用一次，控制路径上使用句柄访问设备
+ * @param id 设备唯一标识符
+ * @return DeviceHandle 设备句柄，设备不存在返回无效句柄
+ */
+DeviceHandle DeviceManager::getHandle(const std::string& id) const {
+    std::lock_guard<std::mutex> lock(devicesMutex);
+    auto it = devices.find(id);
+    if (it == devices.end()) {
+        return DeviceHandle{};
+    }
+    for (size_t i = 0; i < handles.size(); i++) {
+        if (handles[i].slot == &it->second) {
+            return DeviceHandle{(static_cast<uint32_t>(handles[i].generation) << 16) | static_cast<uint32_t>(i + 1)};
+        }
+    }
+    return DeviceHandle{};
+}
+
+/**
+ * @brief 按句柄向设备发送命令
+ * @details 不构造字符串、不做哈希查找，也不分配内存；句柄失效时返回false
+ * @param handle 设备句柄
+ * @param command 命令字节
+ * @param data 命令数据
+ * @return bool 发送成功返回true
+ */
+bool DeviceManager::sendCommand(DeviceHandle handle, uint8_t command, const uint8_t *data) {
+    std::lock_guard<std::mutex> lock(devicesMutex);
+    DeviceSlot* slot = lookup(handle);
+    if (!slot) {
+        BLOG(WARNING, "设备句柄 0x%08X 无效", handle.value);
+        return false;
+    }
+    return visitDevice(*slot, [command, data](auto& device) { return device.sendCommand(command, data); });
+}
+
+/**
+ * @brief 按句柄获取设备实例
+ * @return Device* 设备指针，句柄无效返回nullptr
+ * @note 返回的指针在设备被移除后失效
+ */
+Device* DeviceManager::getDevice(DeviceHandle handle) {
+    std::lock_guard<std::mutex> lock(devicesMutex);
+    DeviceSlot* slot = lookup(handle);
+    if (!slot) {
+        return nullptr;
+    }
+    return visitDevice(*slot, [](Device& device) { return &device; });
 }
 
 /**
  * @brief 处理设备状态变化
- * @details 当设备状态发生变化时调用此方法
- *          - 记录状态变化日志
- *          - 可以扩展为触发其他事件或通知机制
+ * @details 由设备在心跳线程或调用线程中调用，只将事件投递到设备事件总线，不做其它处理，
+ *          订阅者在总线线程中收到事件
  * @param id 设备唯一标识符
  * @param status 新的设备状态
- * @note 此方法由设备实例在状态变化时调用
- *       - 例如连接成功、断开连接、发生错误等
  */
 void DeviceManager::handleDeviceStatusChange(const std::string& id, DeviceStatus status) {
+    if (!DeviceEventBus::getInstance().postStatus(id, status)) {
+        LOG_WARNING("设备事件队列已满，状态变化未投递: [" + id + "]");
+    }
+}
+
+/**
+ * @brief 事件总线回调：记录状态变化与错误标志
+ * @param event 设备事件
+ */
+void DeviceManager::logDeviceEvent(const DeviceEvent& event) {
+    if (event.type == DeviceEventType::ERROR_FLAGS) {
+        char flags[32];
+        std::snprintf(flags, sizeof(flags), "0x%02X -> 0x%02X", event.previousErrorState, event.errorState);
+        if (event.errorState != 0) {
+            LOG_WARNING("设备错误标志: [" + event.deviceId + "] " + flags);
+        } else {
+            LOG_INFO("设备错误标志已清除: [" + event.deviceId + "] " + flags);
+        }
+        return;
+    }
+
     std::string statusStr;
-    switch (status) {
+    switch (event.status) {
         case DeviceStatus::DISCONNECTED:
             statusStr = "未连接";
             break;
@@ -204,6 +413,9 @@ void DeviceManager::handleDeviceStatusChange(const std::string& id, DeviceStatus
         case DeviceStatus::ACTIVE:
             statusStr = "活动中";
             break;
+        case DeviceStatus::OFFLINE:
+            statusStr = "离线";
+            break;
         case DeviceStatus::ERROR:
             statusStr = "错误";
             break;
@@ -212,5 +424,5 @@ void DeviceManager::handleDeviceStatusChange(const std::string& id, DeviceStatus
             break;
     }
     
-    LOG_INFO("设备状态更新: [" + id + "] -> " + statusStr);
+    LOG_INFO("设备状态更新: [" + event.deviceId + "] -> " + statusStr);
 }
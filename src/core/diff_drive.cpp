@@ -0,0 +1,148 @@
+/**
+ * @file diff_drive.cpp
+ * @brief 双履带差速运动学与里程计实现文件
+ * @details 两侧读数独立到达：只在两侧都有新读数时按两侧的累计增量成对积分，
+ *          避免只有一侧增量时航向被单侧行程带偏、再以偏航向投影造成横向漂移；
+ *          中心行程为两侧增量之和的一半、航向增量为两侧增量之差除以轮距，按中点航向投影到平面
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "diff_drive.h"
+#include "global_config.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief DiffDrive构造函数
+ * @param left 左侧电机
+ * @param right 右侧电机
+ * @param geometry 底盘几何参数
+ */
+DiffDrive::DiffDrive(CANDevice& left, CANDevice& right, const DriveGeometry& geometry)
+    : geometry_(geometry),
+      metersPerCentiDegree_(geometry.wheelRadius * M_PI / 18000.0 / geometry.gearRatio),
+      left_{&left, geometry.leftSign, false, 0, 0, 0, false},
+      right_{&right, geometry.rightSign, false, 0, 0, 0, false},
+      state_{0.0, 0.0, 0.0, 0.0, 0}
+{
+    pose_.write([&](OdometryPose& p) { p = state_; });
+}
+
+/**
+ * @brief 按线速度/角速度驱动底盘
+ * @param linear 中心线速度(m/s)，前进为正
+ * @param angular 角速度(rad/s)，逆时针为正
+ * @return bool 两侧命令均发送成功返回true
+ */
+bool DiffDrive::drive(double linear, double angular)
+{
+    double halfTrack = geometry_.trackWidth / 2.0;
+    double toDps = 180.0 / M_PI / geometry_.wheelRadius * geometry_.gearRatio;
+    double leftDps = (linear - angular * halfTrack) * toDps;
+    double rightDps = (linear + angular * halfTrack) * toDps;
+
+    // 超出最大转速时两侧等比例缩放，保持转弯半径不变
+    double peak = std::fmax(std::fabs(leftDps), std::fabs(rightDps));
+    if (peak > geometry_.maxMotorSpeed)
+    {
+        double scale = geometry_.maxMotorSpeed / peak;
+        leftDps *= scale;
+        rightDps *= scale;
+    }
+
+    bool ok = sendSpeed(*left_.device, leftDps * left_.sign);
+    return sendSpeed(*right_.device, rightDps * right_.sign) && ok;
+}
+
+/**
+ * @brief 由 global_config.h 中的 DRIVE_* 参数构成的默认几何参数
+ */
+DriveGeometry DiffDrive::defaultGeometry()
+{
+    return {DRIVE_WHEEL_RADIUS_M, DRIVE_TRACK_WIDTH_M, DRIVE_GEAR_RATIO,
+            DRIVE_LEFT_SIGN, DRIVE_RIGHT_SIGN, DRIVE_MAX_MOTOR_SPEED_DPS};
+}
+
+bool DiffDrive::stop()
+{
+    return drive(0.0, 0.0);
+}
+
+// 发出 0xA2 速度闭环命令
+bool DiffDrive::sendSpeed(CANDevice& device, double dps)
+{
+    units::CentiDps speed = units::from_value<units::CentiDps>(dps);
+    return device.postCommand(MotorCodec::SpeedControl::encode(speed.raw()));
+}
+
+/**
+ * @brief 读取一侧的多圈位置，有新读数时记下并标记为待积分
+ * @details 第一次读数只作为基准；另一侧读数未到时可多次调用，增量在 latest 中累计
+ * @param track 单侧状态
+ */
+void DiffDrive::poll(Track& track)
+{
+    MotorTelemetry telemetry = track.device->getTelemetry();
+    if (telemetry.multi_position_ns == 0 || telemetry.multi_position_ns == track.timestamp_ns)
+    {
+        return;
+    }
+    track.latest = telemetry.multi_position;
+    track.timestamp_ns = telemetry.multi_position_ns;
+    if (!track.valid)
+    {
+        track.position = track.latest;
+        track.valid = true;
+        return;
+    }
+    track.fresh = true;
+}
+
+/**
+ * @brief 积分两侧新到的多圈位置读数
+ * @details 两侧都有新读数时才积分，否则不做任何计算，可在控制周期中每周期调用
+ * @return bool 位姿有更新返回true
+ */
+bool DiffDrive::update()
+{
+    poll(left_);
+    poll(right_);
+    if (!left_.fresh || !right_.fresh)
+    {
+        return false;
+    }
+
+    double leftTravel = static_cast<double>(left_.latest - left_.position) * metersPerCentiDegree_ * left_.sign;
+    double rightTravel = static_cast<double>(right_.latest - right_.position) * metersPerCentiDegree_ * right_.sign;
+    left_.position = left_.latest;
+    right_.position = right_.latest;
+    left_.fresh = false;
+    right_.fresh = false;
+
+    double ds = (leftTravel + rightTravel) / 2.0;
+    double dtheta = (rightTravel - leftTravel) / geometry_.trackWidth;
+    double heading = state_.theta + dtheta / 2.0;
+    state_.x += ds * std::cos(heading);
+    state_.y += ds * std::sin(heading);
+    state_.theta += dtheta;
+    state_.distance += ds;
+    state_.timestamp_ns = std::max(state_.timestamp_ns, std::max(left_.timestamp_ns, right_.timestamp_ns));
+    pose_.write([&](OdometryPose& p) { p = state_; });
+    return true;
+}
+
+/**
+ * @brief 将当前位置设为原点，下一次读数重新作为两侧基准
+ * @note 应在 update() 所在线程调用
+ */
+void DiffDrive::resetPose()
+{
+    state_ = OdometryPose{0.0, 0.0, 0.0, 0.0, 0};
+    left_.valid = false;
+    left_.timestamp_ns = 0;
+    left_.fresh = false;
+    right_.valid = false;
+    right_.timestamp_ns = 0;
+    right_.fresh = false;
+    pose_.write([&](OdometryPose& p) { p = state_; });
+}
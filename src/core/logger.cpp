@@ -27,7 +27,10 @@ Logger& Logger::getInstance() {
  *          - 设置默认日志文件为logs/device_control.log
  *          - 默认启用终端输出
  */
-Logger::Logger() : consoleOutputEnabled(true) {
+Logger::Logger()
+    : segmentSize(LOG_SEGMENT_SIZE), segmentCount(LOG_SEGMENT_COUNT), segmentMaxAge(LOG_SEGMENT_MAX_AGE_S),
+      consoleOutputEnabled(true), minLevel(DEBUG), asyncEnabled(false), writerRunning(false),
+      droppedCount(0), pendingCount(0), overflowPolicy(LogOverflowPolicy::DROP) {
     // 创建日志目录（如果不存在）
     std::string logDir = "logs";
     if (!std::filesystem::exists(logDir)) {
@@ -43,39 +46,69 @@ Logger::Logger() : consoleOutputEnabled(true) {
  * @details 关闭打开的日志文件，释放资源
  */
 Logger::~Logger() {
-    if (logFile.is_open()) {
-        logFile.close();
-    }
+    stopWriter();
+    std::lock_guard<std::mutex> lock(logMutex);
+    logFile.close();
 }
 
 /**
  * @brief 记录日志信息
  * @details 线程安全的日志记录函数，同时输出到控制台和文件
- *          - 使用互斥锁保证线程安全
+ *          - 同步模式：使用互斥锁保证线程安全，在调用线程中格式化并写出
+ *          - 异步模式：只将日志放入无锁队列，由后台线程格式化并批量写出
  *          - 自动添加时间戳和日志级别
- *          - 同时输出到控制台和日志文件
  * @param level 日志级别 (DEBUG, INFO, WARNING, ERROR, CRITICAL)
  * @param message 要记录的日志消息
  */
 void Logger::log(LogLevel level, const std::string& message) {
+    // 先登记再检查模式，保证 stopWriter 能等到所有进入异步路径的调用完成
+    pendingCount.fetch_add(1);
+    if (asyncEnabled.load()) {
+        LogRecord record{level, std::chrono::system_clock::now(), message};
+        while (!queue->tryPush(std::move(record))) {
+            if (overflowPolicy == LogOverflowPolicy::DROP) {
+                pendingCount.fetch_sub(1);
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            std::this_thread::yield();
+        }
+        return;
+    }
+    pendingCount.fetch_sub(1);
+
     std::lock_guard<std::mutex> lock(logMutex);
+    writeRecord({level, std::chrono::system_clock::now(), message});
+    // 警告及以上立即落盘，其余日志积累在缓冲区中按时间间隔刷新，避免每行一次系统调用
+    auto now = std::chrono::steady_clock::now();
+    if (level >= WARNING || now - lastFlush >= std::chrono::milliseconds(LOG_FLUSH_INTERVAL_MS)) {
+        logFile.flush();
+        lastFlush = now;
+    }
+}
 
+/**
+ * @brief 格式化并写出一条日志
+ * @details 输出到控制台（如启用）和日志文件，不主动刷新文件
+ * @param record 日志条目
+ * @note 调用者需持有 logMutex
+ */
+void Logger::writeRecord(const LogRecord& record) {
     // 确保日志文件已打开
-    if (!logFile.is_open()) {
+    if (!logFile.isOpen()) {
         std::cerr << "日志文件未打开！" << std::endl;
         return;
     }
 
-    auto now = std::chrono::system_clock::now();
-    auto now_time_t = std::chrono::system_clock::to_time_t(now);
-    auto now_tm = *std::localtime(&now_time_t);
-    
-    std::ostringstream timestamp;
-    timestamp << std::put_time(&now_tm, "%Y-%m-%d %H:%M:%S");
+    auto now_time_t = std::chrono::system_clock::to_time_t(record.time);
+    std::tm now_tm;
+    localtime_r(&now_time_t, &now_tm);
+    char timestamp[32];
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &now_tm);
 
     // 将日志级别枚举转换为字符串
-    std::string levelStr;
-    switch(level) {
+    const char* levelStr = "";
+    switch(record.level) {
         case DEBUG: levelStr = "DEBUG"; break;
         case INFO: levelStr = "INFO"; break;
         case WARNING: levelStr = "WARNING"; break;
@@ -84,24 +117,108 @@ void Logger::log(LogLevel level, const std::string& message) {
     }
 
     // 构造完整的日志条目
-    std::ostringstream logEntry;
-    logEntry << "[" << timestamp.str() << "] [" << levelStr << "] " << message;
+    std::string logEntry;
+    logEntry.reserve(record.message.size() + 48);
+    logEntry.append("[").append(timestamp).append("] [").append(levelStr).append("] ").append(record.message).append("\n");
 
     // 根据开关决定是否输出到控制台
     if (consoleOutputEnabled) {
-        std::cout << logEntry.str() << std::endl;
+        std::cout << logEntry << std::flush;
     }
 
-    // 写入文件
-    logFile << logEntry.str() << std::endl;
+    // 写入文件缓冲区
+    logFile.write(logEntry.data(), logEntry.size());
+}
+
+/**
+ * @brief 切换异步日志模式
+ * @details 异步模式下日志调用只做一次无锁入队，格式化和文件写入在后台线程中批量完成，
+ *          不再阻塞 CAN 收发等调用线程
+ *          - 关闭异步模式时会先写完队列中剩余的日志
+ * @param enabled true 启用异步模式，false 恢复同步模式
+ * @param capacity 队列容量（向上取整为2的幂）
+ * @param policy 队列满时的处理策略
+ */
+void Logger::setAsync(bool enabled, size_t capacity, LogOverflowPolicy policy) {
+    stopWriter();
+    if (!enabled) {
+        return;
+    }
+
+    queue = std::make_unique<MPMCQueue<LogRecord>>(capacity);
+    overflowPolicy = policy;
+    writerRunning = true;
+    writerThread = std::thread(&Logger::writerLoop, this);
+    asyncEnabled.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief 等待异步队列中的日志全部写出
+ * @details 同步模式下直接返回
+ */
+void Logger::flush() {
+    while (asyncEnabled.load() && pendingCount.load() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::lock_guard<std::mutex> lock(logMutex);
     logFile.flush();
 }
 
+/**
+ * @brief 后台写线程主循环
+ * @details 每次最多取出一批日志依次写入缓冲区，整批只刷新一次文件；队列为空时短暂休眠
+ */
+void Logger::writerLoop() {
+    const int batchSize = 256;
+    LogRecord record;
+    while (true) {
+        int written = 0;
+        {
+            std::lock_guard<std::mutex> lock(logMutex);
+            while (written < batchSize && queue->tryPop(record)) {
+                writeRecord(record);
+                written++;
+            }
+            if (written > 0) {
+                logFile.flush();
+                lastFlush = std::chrono::steady_clock::now();
+            }
+        }
+        pendingCount.fetch_sub(written);
+
+        if (written == 0) {
+            if (!writerRunning.load(std::memory_order_acquire)) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+}
+
+/**
+ * @brief 停止后台写线程
+ * @details 先切回同步模式再等待后台线程写完剩余日志
+ */
+void Logger::stopWriter() {
+    if (!asyncEnabled.exchange(false)) {
+        return;
+    }
+    // 等待已进入异步路径的日志全部入队并写出
+    while (pendingCount.load() > 0) {
+        std::this_thread::yield();
+    }
+    writerRunning = false;
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+    queue.reset();
+}
+
 /**
  * @brief 设置日志文件路径
  * @details 线程安全地更改日志输出文件
  *          - 关闭当前日志文件（如果已打开）
- *          - 尝试打开新的日志文件
+ *          - 以滚动分段方式打开新的日志文件，历史分段为 <name>.1.log ~ <name>.<N-1>.log
  *          - 如果目录不存在则自动创建
  *          - 如果无法创建文件则回退到控制台输出
  * @param filename 新的日志文件路径
@@ -110,26 +227,43 @@ void Logger::setLogFile(const std::string& filename) {
     std::lock_guard<std::mutex> lock(logMutex);
     
     // 关闭当前文件（如果已打开）
-    if (logFile.is_open()) {
-        logFile.close();
-    }
+    logFile.close();
+    logFileName = filename;
     
     // 打开新文件
-    logFile.open(filename, std::ios::out | std::ios::app);
-    if (!logFile.is_open()) {
-        std::cerr << "打开日志文件失败: " << filename << std::endl;
+    if (!logFile.open(filename, segmentSize, segmentCount, segmentMaxAge)) {
         // 尝试创建父目录
         auto parent_path = std::filesystem::path(filename).parent_path();
         if (!parent_path.empty() && !std::filesystem::exists(parent_path)) {
             std::filesystem::create_directories(parent_path);
-            logFile.open(filename, std::ios::out | std::ios::app);
+            logFile.open(filename, segmentSize, segmentCount, segmentMaxAge);
         }
         
         // 如果仍然失败，使用标准错误输出
-        if (!logFile.is_open()) {
+        if (!logFile.isOpen()) {
             std::cerr << "无法创建或打开日志文件，日志将只输出到控制台" << std::endl;
         }
     }
+    lastFlush = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief 设置日志文件滚动参数
+ * @details 立即以新参数重新打开当前日志文件，磁盘占用上限为 segmentSize * segmentCount
+ * @param segmentSize 单个分段的最大字节数
+ * @param segmentCount 分段数量（含当前分段）
+ * @param maxAge 单个分段最长写入时间，0 表示只按大小滚动
+ */
+void Logger::setRotation(size_t segmentSize, int segmentCount, std::chrono::seconds maxAge) {
+    std::string filename;
+    {
+        std::lock_guard<std::mutex> lock(logMutex);
+        this->segmentSize = segmentSize;
+        this->segmentCount = segmentCount;
+        segmentMaxAge = maxAge;
+        filename = logFileName;
+    }
+    setLogFile(filename);
 }
 
 /**
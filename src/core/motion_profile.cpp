@@ -0,0 +1,173 @@
+/**
+ * @file motion_profile.cpp
+ * @brief 加加速度受限的运动曲线生成器实现文件
+ * @details 速度跟踪采用“预估停加速后的速度”判据：若此刻开始以最大加加速度把加速度降到0，
+ *          速度将停在 v + a|a|/(2J)；该值未到目标则继续向目标方向加速，否则开始收加速度。
+ *          位置模式每周期计算假设再加速一个周期后受限制动所需的距离，距离不足时以0为目标制动，否则向最大速度加速。
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "motion_profile.h"
+#include <cmath>
+
+static double clampAbs(double value, double limit)
+{
+    return value > limit ? limit : (value < -limit ? -limit : value);
+}
+
+MotionProfile::MotionProfile(const ProfileLimits& limits)
+    : limits_(limits), state_{0.0, 0.0, 0.0}, mode_(Mode::VELOCITY), target_(0.0) {}
+
+void MotionProfile::setLimits(const ProfileLimits& limits)
+{
+    limits_ = limits;
+}
+
+/**
+ * @brief 重置曲线状态
+ * @details 用于从实际测量值重新起步，目标被设为保持当前速度
+ * @param state 新状态
+ */
+void MotionProfile::reset(const ProfileState& state)
+{
+    state_ = state;
+    mode_ = Mode::VELOCITY;
+    target_ = state.velocity;
+}
+
+void MotionProfile::setVelocityTarget(double velocity)
+{
+    mode_ = Mode::VELOCITY;
+    target_ = clampAbs(velocity, limits_.maxVelocity);
+}
+
+void MotionProfile::setPositionTarget(double position)
+{
+    mode_ = Mode::POSITION;
+    target_ = position;
+}
+
+/**
+ * @brief 推进一个周期
+ * @param dt 周期(秒)
+ * @return const ProfileState& 本周期结束时的设定值
+ */
+const ProfileState& MotionProfile::step(double dt)
+{
+    if (mode_ == Mode::VELOCITY)
+    {
+        trackVelocity(target_, dt);
+        state_.position += state_.velocity * dt;
+        return state_;
+    }
+
+    double error = target_ - state_.position;
+    double direction = error >= 0 ? 1.0 : -1.0;
+    double v = state_.velocity * direction;
+    double a = state_.acceleration * direction;
+    double stepJerk = limits_.maxJerk * dt;
+    if (std::fabs(error) <= stepJerk * dt * dt && std::fabs(v) <= stepJerk * dt && std::fabs(a) <= stepJerk)
+    {
+        // 剩余距离与速度都在一个周期的变化量以内：落到目标
+        state_.position = target_;
+        state_.velocity = 0.0;
+        state_.acceleration = 0.0;
+        return state_;
+    }
+    // 假设本周期继续加速，若从下一周期的状态已来不及制动，则本周期开始制动
+    double nextA = std::fmin(a + stepJerk, limits_.maxAcceleration);
+    double nextV = v + nextA * dt;
+    bool brake = nextV > 0 && stoppingDistance(nextV, nextA) + nextV * dt >= std::fabs(error);
+    if (brake && std::fabs(v) <= stepJerk * dt && std::fabs(a) <= stepJerk)
+    {
+        // 已静止且剩余距离小于一次最小起停的行程：直接落到目标
+        state_.position = target_;
+        state_.velocity = 0.0;
+        state_.acceleration = 0.0;
+        return state_;
+    }
+    trackVelocity(brake ? 0.0 : direction * limits_.maxVelocity, dt);
+    state_.position += state_.velocity * dt;
+    return state_;
+}
+
+/**
+ * @brief 是否已到达目标（速度模式：速度稳定在目标；位置模式：停在目标位置）
+ */
+bool MotionProfile::done() const
+{
+    if (mode_ == Mode::VELOCITY)
+    {
+        return state_.velocity == target_ && state_.acceleration == 0.0;
+    }
+    return state_.position == target_ && state_.velocity == 0.0;
+}
+
+/**
+ * @brief 加加速度受限的速度跟踪
+ * @param target 目标速度
+ * @param dt 周期(秒)
+ */
+void MotionProfile::trackVelocity(double target, double dt)
+{
+    double jerk = limits_.maxJerk;
+    double stepJerk = jerk * dt;
+    double a = state_.acceleration;
+    double v = state_.velocity;
+
+    // 进入一个周期的变化量以内时直接落到目标，避免在目标附近抖动
+    if (std::fabs(target - v) <= stepJerk * dt && std::fabs(a) <= stepJerk)
+    {
+        state_.velocity = target;
+        state_.acceleration = 0.0;
+        return;
+    }
+
+    // 从现在开始收加速度，速度最终停在 vStop
+    double vStop = v + a * std::fabs(a) / (2.0 * jerk);
+    double error = target - vStop;
+    double desired = 0.0;
+    if (std::fabs(error) > stepJerk * dt)
+    {
+        desired = error > 0 ? limits_.maxAcceleration : -limits_.maxAcceleration;
+    }
+    a += clampAbs(desired - a, stepJerk);
+    v += a * dt;
+    state_.acceleration = a;
+    state_.velocity = v;
+}
+
+/**
+ * @brief 从当前状态以受限加加速度制动到零速所需的距离
+ * @details 制动分三段：加速度以 J 降到 -Ap，保持 -Ap，再以 J 回到0，速度恰好在末端归零；
+ *          Ap 不超过最大加速度，制动速度增量不足以达到最大加速度时没有中间段
+ * @param v 沿运动方向的速度（正）
+ * @param a 沿运动方向的加速度
+ * @return double 制动距离
+ */
+double MotionProfile::stoppingDistance(double v, double a) const
+{
+    double jerk = limits_.maxJerk;
+    double peak = std::sqrt(jerk * v + a * a / 2.0);
+    double hold = 0.0;
+    if (peak > limits_.maxAcceleration)
+    {
+        peak = limits_.maxAcceleration;
+        hold = (v + a * a / (2.0 * jerk) - peak * peak / jerk) / peak;
+    }
+    if (a < -peak)
+    {
+        // 已在以更大减速度制动：只剩把加速度收回0的一段
+        double t = -a / jerk;
+        return v * t + a * t * t / 2.0 + jerk * t * t * t / 6.0;
+    }
+
+    double t1 = (a + peak) / jerk;
+    double d1 = v * t1 + a * t1 * t1 / 2.0 - jerk * t1 * t1 * t1 / 6.0;
+    double v1 = v + a * t1 - jerk * t1 * t1 / 2.0;
+    double d2 = v1 * hold - peak * hold * hold / 2.0;
+    double v2 = v1 - peak * hold;
+    double t3 = peak / jerk;
+    double d3 = v2 * t3 - peak * t3 * t3 / 2.0 + jerk * t3 * t3 * t3 / 6.0;
+    return d1 + d2 + d3;
+}
@@ -0,0 +1,431 @@
+/**
+ * @file poll_scheduler.cpp
+ * @brief 遥测轮询调度器实现文件
+ * @details 在独立线程中按计划发出状态/位置读取请求，响应由 CAN 接收线程分发给设备解析；
+ *          设备经 DeviceManager::withDevice 按句柄访问，期间只持有设备表的锁，不持有调度器的锁
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "poll_scheduler.h"
+#include "global_config.h"
+#include "logger.h"
+#include "periodic_deadline.h"
+#include <algorithm>
+#include <chrono>
+
+// 响应帧最坏情况位数：8字节标准帧，含最多填充位与帧间隔
+static constexpr uint32_t WORST_REPLY_BITS = 135;
+// 存在未完成请求时检查响应的间隔
+static constexpr int64_t REPLY_CHECK_NS = 200000;
+
+static int64_t monotonicNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief PollScheduler构造函数
+ * @param manager 轮询设备所在的设备管理器，用于解析设备句柄
+ * @param can 轮询所在的CAN接口，用于估算总线预算
+ * @param busBudget 轮询可占用的总线比例(0.0~1.0)
+ */
+PollScheduler::PollScheduler(DeviceManager& manager, CANInterface& can, double busBudget)
+    : manager_(manager), can_(can), busBudget_(busBudget), scale_(1.0), pipelineDepth_(4),
+      replyTimeout_ns_(20000000), running_(false) {}
+
+PollScheduler::~PollScheduler()
+{
+    stop();
+}
+
+/**
+ * @brief 添加轮询项
+ * @details 同一 (设备, 命令) 重复添加时更新其目标频率
+ * @param device 目标电机的设备句柄
+ * @param command 读取命令，仅支持状态与位置读取命令
+ * @param rateHz 目标轮询频率(Hz)
+ * @return bool 添加成功返回true，句柄无效或不是 CAN 电机返回false
+ */
+bool PollScheduler::addPoll(DeviceHandle device, MOTOR_COMMAND command, double rateHz)
+{
+    switch (command)
+    {
+    case MOTOR_GET_MULTI_POSITION:
+    case MOTOR_GET_SINGLE_POSITION:
+    case MOTOR_GET_STATUS1:
+    case MOTOR_GET_STATUS2:
+    case MOTOR_GET_STATUS3:
+        break;
+    default:
+        LOG_WARNING("轮询调度器仅支持状态/位置读取命令: " + std::to_string(static_cast<int>(command)));
+        return false;
+    }
+    if (rateHz <= 0.0)
+    {
+        LOG_WARNING("无效的轮询频率: " + std::to_string(rateHz));
+        return false;
+    }
+    std::string id;
+    int node = 0;
+    if (!manager_.withDevice<CANDevice>(device, [&](CANDevice& motor) { id = motor.getId(); node = motor.getNode(); }))
+    {
+        LOG_WARNING("轮询设备句柄无效或不是 CAN 电机: " + std::to_string(device.value));
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    PollEntry* existing = findEntry(device, static_cast<uint8_t>(command));
+    if (existing)
+    {
+        existing->targetRate = rateHz;
+    }
+    else
+    {
+        PollEntry entry{};
+        entry.device = device;
+        entry.deviceId = id;
+        entry.node = node;
+        entry.command = static_cast<uint8_t>(command);
+        entry.targetRate = rateHz;
+        entries_.push_back(entry);
+    }
+    replan();
+    cv_.notify_all();
+    LOG_INFO("添加轮询: [" + id + "] 命令 0x" + std::to_string(static_cast<int>(command)) + " @ " + std::to_string(rateHz) + " Hz");
+    return true;
+}
+
+/**
+ * @brief 移除轮询项
+ * @param device 目标电机的设备句柄
+ * @param command 读取命令
+ * @return bool 存在并移除返回true
+ */
+bool PollScheduler::removePoll(DeviceHandle device, MOTOR_COMMAND command)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(entries_.begin(), entries_.end(), [&](const PollEntry& e) {
+        return e.device == device && e.command == command;
+    });
+    if (it == entries_.end())
+    {
+        return false;
+    }
+    entries_.erase(it);
+    replan();
+    return true;
+}
+
+/**
+ * @brief 设置轮询可占用的总线比例
+ * @param fraction 总线比例(0.0~1.0)
+ */
+void PollScheduler::setBusBudget(double fraction)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    busBudget_ = fraction;
+    replan();
+}
+
+/**
+ * @brief 设置流水线深度
+ * @details 即全局同时未完成的请求数上限，深度越大响应重叠越多
+ * @param depth 流水线深度(>=1)
+ */
+void PollScheduler::setPipelineDepth(int depth)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pipelineDepth_ = std::max(1, depth);
+}
+
+/**
+ * @brief 设置请求响应超时
+ * @param timeout_ms 超时时间(毫秒)，超时后该请求计为丢失并释放流水线位置
+ */
+void PollScheduler::setReplyTimeout(uint32_t timeout_ms)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    replyTimeout_ns_ = static_cast<int64_t>(timeout_ms) * 1000000;
+}
+
+/**
+ * @brief 启动调度线程
+ * @return bool 启动成功返回true
+ */
+bool PollScheduler::start()
+{
+    if (running_.exchange(true))
+    {
+        return true;
+    }
+    thread_ = std::thread(&PollScheduler::run, this);
+    return true;
+}
+
+/**
+ * @brief 停止调度线程
+ */
+void PollScheduler::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+}
+
+/**
+ * @brief 获取预算约束后的频率缩放系数
+ * @return double 1.0 表示所有目标频率均可满足
+ */
+double PollScheduler::getScale() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return scale_;
+}
+
+/**
+ * @brief 获取各轮询项的统计信息
+ * @return std::vector<PollStats> 统计信息列表
+ */
+std::vector<PollScheduler::PollStats> PollScheduler::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<PollStats> stats;
+    for (const auto& e : entries_)
+    {
+        stats.push_back({e.deviceId, e.command, e.targetRate, e.targetRate * scale_, e.sent, e.answered, e.missed});
+    }
+    return stats;
+}
+
+/**
+ * @brief 重新计算轮询计划
+ * @details 每个轮询项的总线开销为请求帧实际位数加响应帧最坏位数；
+ *          总需求超出预算时所有频率按同一比例缩小，
+ *          并将各项首次发送时间在一个周期内错开，避免请求集中突发
+ * @note 调用者需持有 mutex_
+ */
+void PollScheduler::replan()
+{
+    double demand = 0.0;
+    for (const auto& e : entries_)
+    {
+        struct can_frame request = {};
+        request.can_id = 0x140 + e.node;
+        request.can_dlc = 8;
+        request.data[0] = e.command;
+        demand += e.targetRate * (CANInterface::frameBitCount(request) + WORST_REPLY_BITS);
+    }
+
+    double budget = busBudget_ * CAN_BUS_BITRATE;
+    double scale = (demand > budget && demand > 0.0) ? budget / demand : 1.0;
+    if (scale < 1.0)
+    {
+        LOG_WARNING("轮询需求 " + std::to_string(static_cast<int>(demand * 100 / CAN_BUS_BITRATE)) + "% 超出总线预算 " +
+                    std::to_string(static_cast<int>(busBudget_ * 100)) + "%，所有轮询频率按 " + std::to_string(scale) + " 缩放");
+    }
+    scale_ = scale;
+
+    int64_t now = monotonicNs();
+    size_t n = entries_.size();
+    for (size_t i = 0; i < n; i++)
+    {
+        PollEntry& e = entries_[i];
+        e.period_ns = static_cast<int64_t>(1e9 / (e.targetRate * scale_));
+        e.next_due_ns = now + e.period_ns * static_cast<int64_t>(i) / static_cast<int64_t>(n);
+    }
+}
+
+/**
+ * @brief 按设备句柄与命令查找轮询项
+ * @note 调用者需持有 mutex_
+ */
+PollScheduler::PollEntry* PollScheduler::findEntry(DeviceHandle device, uint8_t command)
+{
+    for (auto& e : entries_)
+    {
+        if (e.device == device && e.command == command)
+        {
+            return &e;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief 删除设备已被移除的轮询项并重新计划
+ * @note 调用者需持有 mutex_
+ */
+void PollScheduler::pruneRemoved()
+{
+    for (const auto& e : entries_)
+    {
+        if (e.removed)
+        {
+            LOG_WARNING("设备 [" + e.deviceId + "] 已移除，删除其轮询项: 命令 " + std::to_string(static_cast<int>(e.command)));
+        }
+    }
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(), [](const PollEntry& e) { return e.removed; }),
+                   entries_.end());
+    replan();
+}
+
+/**
+ * @brief 检查未完成请求的响应
+ * @details 读取设备响应序号时释放 mutex_，返回前重新加锁；期间被移除的轮询项直接跳过
+ * @param lock 调度线程持有的 mutex_
+ * @param now 当前时间(纳秒)
+ * @return int64_t 仍未完成的请求数
+ */
+int64_t PollScheduler::collectReplies(std::unique_lock<std::mutex>& lock, int64_t now)
+{
+    checks_.clear();
+    for (const auto& e : entries_)
+    {
+        if (e.inflight)
+        {
+            checks_.push_back({e.device, e.command, 0, false});
+        }
+    }
+    if (checks_.empty())
+    {
+        return 0;
+    }
+
+    lock.unlock();
+    for (auto& check : checks_)
+    {
+        check.present = manager_.withDevice<CANDevice>(check.device, [&](CANDevice& motor) {
+            check.reply_seq = motor.replySequence(check.command);
+        });
+    }
+    lock.lock();
+
+    int64_t outstanding = 0;
+    bool removed = false;
+    for (const auto& check : checks_)
+    {
+        PollEntry* e = findEntry(check.device, check.command);
+        if (!e || !e->inflight)
+        {
+            continue;
+        }
+        if (!check.present)
+        {
+            e->removed = true;
+            removed = true;
+        }
+        else if (check.reply_seq != e->reply_seq)
+        {
+            e->inflight = false;
+            e->answered++;
+        }
+        else if (now - e->sent_ns >= replyTimeout_ns_)
+        {
+            e->inflight = false;
+            e->missed++;
+        }
+        else
+        {
+            outstanding++;
+        }
+    }
+    if (removed)
+    {
+        pruneRemoved();
+    }
+    return outstanding;
+}
+
+/**
+ * @brief 调度线程主循环
+ * @details 每轮按最早截止时间优先依次发出到期请求，直到流水线填满；
+ *          发送后不等待响应，下一轮再统一回收。发送时释放 mutex_，
+ *          增删轮询项与读取统计不会被总线调节器和套接字写入阻塞
+ */
+void PollScheduler::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_)
+    {
+        int64_t now = monotonicNs();
+        int64_t outstanding = collectReplies(lock, now);
+
+        while (running_ && outstanding < pipelineDepth_)
+        {
+            PollEntry* next = nullptr;
+            for (auto& e : entries_)
+            {
+                if (!e.inflight && e.next_due_ns <= now && (!next || e.next_due_ns < next->next_due_ns))
+                {
+                    next = &e;
+                }
+            }
+            if (!next)
+            {
+                break;
+            }
+
+            // 发送期间占住该项，解锁后 entries_ 可能被修改，重新加锁后按键重新查找
+            DeviceHandle device = next->device;
+            uint8_t command = next->command;
+            next->inflight = true;
+            lock.unlock();
+            uint32_t seq = 0;
+            bool sent = false;
+            bool present = manager_.withDevice<CANDevice>(device, [&](CANDevice& motor) {
+                seq = motor.replySequence(command);
+                sent = motor.postCommand(command);
+            });
+            lock.lock();
+
+            PollEntry* entry = findEntry(device, command);
+            if (!entry)
+            {
+                continue;
+            }
+            entry->inflight = false;
+            if (!present)
+            {
+                entry->removed = true;
+                pruneRemoved();
+                continue;
+            }
+            if (sent)
+            {
+                entry->inflight = true;
+                entry->sent_ns = now;
+                entry->reply_seq = seq;
+                entry->sent++;
+                outstanding++;
+            }
+            else
+            {
+                entry->missed++; // 被总线负载调节器限流或发送失败，本周期放弃
+            }
+
+            // 落后时跳过积压的周期，保持 replan() 错开的相位
+            advanceDeadline(entry->next_due_ns, entry->period_ns, now);
+        }
+
+        int64_t wake = now + 100000000; // 无轮询项时最多休眠100ms
+        for (const auto& e : entries_)
+        {
+            if (!e.inflight)
+            {
+                wake = std::min(wake, e.next_due_ns);
+            }
+        }
+        if (outstanding > 0)
+        {
+            wake = std::min(wake, now + REPLY_CHECK_NS);
+        }
+        cv_.wait_until(lock, std::chrono::steady_clock::time_point(std::chrono::nanoseconds(wake)));
+    }
+}
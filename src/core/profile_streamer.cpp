@@ -0,0 +1,160 @@
+/**
+ * @file profile_streamer.cpp
+ * @brief 运动曲线定频下发器实现文件
+ * @details 周期由 ControlLoop 驱动，每个周期推进一次曲线并以 postCommand 发出设定值，
+ *          响应由 CAN 接收线程解析进遥测，下发线程不等待
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "profile_streamer.h"
+#include "logger.h"
+#include <cmath>
+
+/**
+ * @brief ProfileStreamer构造函数
+ * @param device 目标电机
+ * @param command 下发命令，MOTOR_SPEED_FEEDBACK_CONTROL 或 MOTOR_TORQUE_FEEDBACK_CONTROL
+ * @param limits 曲线约束
+ * @param rateHz 下发频率(Hz)
+ */
+ProfileStreamer::ProfileStreamer(CANDevice& device, MOTOR_COMMAND command, const ProfileLimits& limits, double rateHz)
+    : device_(device), command_(command), profile_(limits),
+      period_ns_(static_cast<int64_t>(1e9 / rateHz)), dt_(1.0 / rateHz),
+      loop_(ControlLoop::Options{period_ns_, 0, -1, false}), ticks_(0), sendFailures_(0)
+{
+    loop_.addTask("profile_streamer", [this](int64_t) { step(); });
+}
+
+ProfileStreamer::~ProfileStreamer()
+{
+    stop();
+}
+
+/**
+ * @brief 启动下发线程
+ * @return bool 启动成功返回true，命令不受支持时返回false
+ */
+bool ProfileStreamer::start()
+{
+    if (!supported())
+    {
+        LOG_ERROR("曲线下发仅支持速度/转矩闭环命令: " + std::to_string(static_cast<int>(command_)));
+        return false;
+    }
+    return loop_.start();
+}
+
+void ProfileStreamer::stop()
+{
+    loop_.stop();
+}
+
+void ProfileStreamer::setLimits(const ProfileLimits& limits)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    profile_.setLimits(limits);
+}
+
+/**
+ * @brief 设置目标值（速度流为 dps，转矩流为 iq），曲线从当前设定值平滑过渡
+ */
+void ProfileStreamer::setTarget(double target)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    profile_.setVelocityTarget(target);
+}
+
+/**
+ * @brief 设置相对位置目标：以速度流转过 delta 度后停止
+ * @param delta 相对当前曲线位置的角度(度)
+ * @return bool 转矩流不支持位置目标，返回false
+ */
+bool ProfileStreamer::setPositionTarget(double delta)
+{
+    if (command_ != MOTOR_SPEED_FEEDBACK_CONTROL)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    profile_.setPositionTarget(profile_.state().position + delta);
+    return true;
+}
+
+/**
+ * @brief 重置曲线状态，例如按测得的转速重新起步
+ */
+void ProfileStreamer::reset(const ProfileState& state)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    profile_.reset(state);
+}
+
+ProfileState ProfileStreamer::getState() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return profile_.state();
+}
+
+bool ProfileStreamer::isDone() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return profile_.done();
+}
+
+ProfileStreamer::StreamStats ProfileStreamer::getStats() const
+{
+    return {ticks_.load(), loop_.getStats().missedPeriods, sendFailures_.load()};
+}
+
+bool ProfileStreamer::supported() const
+{
+    return command_ == MOTOR_SPEED_FEEDBACK_CONTROL || command_ == MOTOR_TORQUE_FEEDBACK_CONTROL;
+}
+
+/**
+ * @brief 由外部周期执行器推进一个周期并下发设定值
+ * @details 与 start() 做相同的检查：命令不受支持或自身下发线程已在运行时不推进，避免同一周期推进两次
+ * @note 调用频率应与构造时的频率一致
+ * @return bool 已推进返回true
+ */
+bool ProfileStreamer::tick()
+{
+    if (!supported() || loop_.isRunning())
+    {
+        return false;
+    }
+    step();
+    return true;
+}
+
+// 推进一个周期并下发设定值
+void ProfileStreamer::step()
+{
+    double value;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        value = profile_.step(dt_).velocity;
+    }
+    if (!send(value))
+    {
+        sendFailures_++;
+    }
+    ticks_++;
+}
+
+/**
+ * @brief 将设定值编码为命令帧并发出，不等待响应
+ * @param value 速度流为 dps，转矩流为 iq
+ * @return bool 发送成功返回true
+ */
+bool ProfileStreamer::send(double value)
+{
+    if (command_ == MOTOR_SPEED_FEEDBACK_CONTROL)
+    {
+        units::CentiDps speed = units::from_value<units::CentiDps>(value);
+        return device_.postCommand(MotorCodec::SpeedControl::encode(speed.raw()));
+    }
+    long iq = std::lround(value);
+    iq = iq > 2048 ? 2048 : (iq < -2048 ? -2048 : iq);
+    return device_.postCommand(MotorCodec::TorqueControl::encode(static_cast<int16_t>(iq)));
+}
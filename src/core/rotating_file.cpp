@@ -0,0 +1,176 @@
+/**
+ * @file rotating_file.cpp
+ * @brief 按大小/时间滚动的日志文件实现文件
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "rotating_file.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+RotatingFile::RotatingFile()
+    : fd_(-1), segmentSize_(0), segmentCount_(1), maxAge_(0), written_(0), used_(0) {}
+
+RotatingFile::~RotatingFile() {
+    close();
+}
+
+/**
+ * @brief 打开滚动日志文件
+ * @details 当前分段已存在时在其末尾继续写入，已写满则立即滚动
+ * @param path 当前分段路径，如 logs/device_control.log
+ * @param segmentSize 单个分段的最大字节数
+ * @param segmentCount 分段数量（含当前分段），总占用不超过 segmentSize * segmentCount
+ * @param maxAge 单个分段最长写入时间，0 表示只按大小滚动
+ * @param bufferSize 写缓冲区大小
+ * @return bool 打开成功返回true
+ */
+bool RotatingFile::open(const std::string& path, size_t segmentSize, int segmentCount,
+                        std::chrono::seconds maxAge, size_t bufferSize) {
+    close();
+    path_ = path;
+    segmentSize_ = segmentSize;
+    segmentCount_ = segmentCount < 1 ? 1 : segmentCount;
+    maxAge_ = maxAge;
+    buffer_.assign(bufferSize, 0);
+    used_ = 0;
+
+    if (!openSegment()) {
+        return false;
+    }
+    if (written_ >= segmentSize_) {
+        rotate();
+    }
+    return isOpen();
+}
+
+/**
+ * @brief 写出缓冲区并关闭文件
+ * @details 截掉预分配但未使用的空间
+ */
+void RotatingFile::close() {
+    if (fd_ < 0) {
+        return;
+    }
+    flush();
+    if (ftruncate(fd_, static_cast<off_t>(written_)) != 0) {
+        std::cerr << "截断日志文件失败: " << std::strerror(errno) << std::endl;
+    }
+    ::close(fd_);
+    fd_ = -1;
+}
+
+/**
+ * @brief 写入数据
+ * @details 写入后将超出分段大小或分段已超时时，先滚动到新分段
+ * @param data 数据
+ * @param length 字节数
+ */
+void RotatingFile::write(const char* data, size_t length) {
+    if (fd_ < 0) {
+        return;
+    }
+    bool expired = maxAge_.count() > 0 && std::chrono::steady_clock::now() - segmentOpened_ >= maxAge_;
+    if ((written_ > 0 && written_ + length > segmentSize_) || expired) {
+        rotate();
+        if (fd_ < 0) {
+            return;
+        }
+    }
+
+    if (used_ + length > buffer_.size()) {
+        flush();
+    }
+    if (length > buffer_.size()) {
+        // 超过缓冲区大小的数据直接写出
+        if (::write(fd_, data, length) < 0) {
+            std::cerr << "写日志文件失败: " << std::strerror(errno) << std::endl;
+        }
+    } else {
+        std::memcpy(buffer_.data() + used_, data, length);
+        used_ += length;
+    }
+    written_ += length;
+}
+
+/**
+ * @brief 将缓冲区内容写入文件
+ */
+void RotatingFile::flush() {
+    if (fd_ < 0 || used_ == 0) {
+        return;
+    }
+    size_t offset = 0;
+    while (offset < used_) {
+        ssize_t n = ::write(fd_, buffer_.data() + offset, used_ - offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "写日志文件失败: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        offset += static_cast<size_t>(n);
+    }
+    used_ = 0;
+}
+
+/**
+ * @brief 打开当前分段并预分配空间
+ * @return bool 打开成功返回true
+ */
+bool RotatingFile::openSegment() {
+    fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        std::cerr << "打开日志文件失败: " << path_ << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+    off_t end = lseek(fd_, 0, SEEK_END);
+    written_ = end > 0 ? static_cast<size_t>(end) : 0;
+    segmentOpened_ = std::chrono::steady_clock::now();
+
+    // 预分配失败（如文件系统不支持）不影响写入
+    if (written_ < segmentSize_) {
+        fallocate(fd_, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(written_), static_cast<off_t>(segmentSize_ - written_));
+    }
+    if (written_ == 0 && segmentCallback_) {
+        segmentCallback_();
+    }
+    return true;
+}
+
+/**
+ * @brief 滚动到新分段
+ * @details 关闭当前分段，历史分段编号依次加一，超出数量的最旧分段被删除
+ */
+void RotatingFile::rotate() {
+    close();
+    std::remove(segmentPath(segmentCount_ - 1).c_str());
+    for (int i = segmentCount_ - 2; i >= 0; i--) {
+        std::rename(segmentPath(i).c_str(), segmentPath(i + 1).c_str());
+    }
+    if (segmentCount_ == 1) {
+        std::remove(path_.c_str());
+    }
+    openSegment();
+}
+
+/**
+ * @brief 获取分段路径
+ * @param index 分段编号，0 为当前分段
+ * @return std::string 分段路径，编号插在扩展名之前
+ */
+std::string RotatingFile::segmentPath(int index) const {
+    if (index == 0) {
+        return path_;
+    }
+    size_t slash = path_.find_last_of('/');
+    size_t dot = path_.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return path_ + "." + std::to_string(index);
+    }
+    return path_.substr(0, dot) + "." + std::to_string(index) + path_.substr(dot);
+}
@@ -0,0 +1,158 @@
+/**
+ * @file telemetry_store.cpp
+ * @brief 全车遥测数据表实现文件
+ * @details 写入由接收线程通过顺序锁完成，读取方拷贝整表后在本地聚合，互不阻塞
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "telemetry_store.h"
+
+/**
+ * @brief 获取TelemetryStore单例实例
+ * @return TelemetryStore& 单例引用
+ */
+TelemetryStore& TelemetryStore::getInstance() {
+    static TelemetryStore instance;
+    return instance;
+}
+
+/**
+ * @brief TelemetryStore构造函数
+ * @details 所有槽位初始化为哨兵值
+ */
+TelemetryStore::TelemetryStore() {
+    for (int i = 0; i < MAX_DEVICES; i++) {
+        clear(i);
+    }
+}
+
+/**
+ * @brief 写入状态1数据
+ * @param handle 设备句柄
+ * @param temperature 电机温度(1℃/LSB)
+ * @param voltage 母线电压(0.01V/LSB)
+ * @param current 母线电流(0.01A/LSB)
+ * @param errorState 错误标志
+ */
+void TelemetryStore::updateStatus1(int handle, int8_t temperature, uint16_t voltage, uint16_t current, uint8_t errorState) {
+    if (handle < 0 || handle >= MAX_DEVICES) {
+        return;
+    }
+    table_.write([&](Table& t) {
+        t.temperature[handle] = temperature;
+        t.voltage[handle] = voltage;
+        t.current[handle] = current;
+        t.errorState[handle] = errorState;
+        t.status1Mask |= 1ull << handle;
+    });
+}
+
+/**
+ * @brief 写入状态2数据
+ * @param handle 设备句柄
+ * @param temperature 电机温度(1℃/LSB)
+ * @param iq 转矩电流((66/4096A)/LSB)
+ * @param speed 电机转速(1dps/LSB)
+ * @param encoder 编码器位置
+ */
+void TelemetryStore::updateStatus2(int handle, int8_t temperature, int16_t iq, int16_t speed, uint16_t encoder) {
+    if (handle < 0 || handle >= MAX_DEVICES) {
+        return;
+    }
+    table_.write([&](Table& t) {
+        t.temperature[handle] = temperature;
+        t.iq[handle] = iq;
+        t.speed[handle] = speed;
+        t.encoder[handle] = encoder;
+        t.status2Mask |= 1ull << handle;
+    });
+}
+
+/**
+ * @brief 仅更新温度（状态3等只携带温度的响应）
+ * @param handle 设备句柄
+ * @param temperature 电机温度(1℃/LSB)
+ */
+void TelemetryStore::updateTemperature(int handle, int8_t temperature) {
+    if (handle < 0 || handle >= MAX_DEVICES) {
+        return;
+    }
+    table_.write([&](Table& t) {
+        t.temperature[handle] = temperature;
+    });
+}
+
+/**
+ * @brief 清除设备槽位
+ * @details 设备移除时调用，槽位恢复为哨兵值，不再参与聚合
+ * @param handle 设备句柄
+ */
+void TelemetryStore::clear(int handle) {
+    if (handle < 0 || handle >= MAX_DEVICES) {
+        return;
+    }
+    table_.write([&](Table& t) {
+        t.temperature[handle] = INVALID_TEMPERATURE;
+        t.voltage[handle] = INVALID_VOLTAGE;
+        t.current[handle] = 0;
+        t.iq[handle] = 0;
+        t.speed[handle] = 0;
+        t.encoder[handle] = 0;
+        t.errorState[handle] = 0;
+        t.status1Mask &= ~(1ull << handle);
+        t.status2Mask &= ~(1ull << handle);
+    });
+}
+
+/**
+ * @brief 计算当前全车健康度
+ * @return FleetHealth 聚合结果
+ */
+TelemetryStore::FleetHealth TelemetryStore::health() const {
+    Table table = table_.load();
+    return aggregate(table);
+}
+
+/**
+ * @brief 对遥测表做全车聚合
+ * @details 每项聚合都是对定长连续数组的无分支遍历，便于编译器向量化
+ * @param table 遥测表
+ * @return FleetHealth 聚合结果
+ */
+TelemetryStore::FleetHealth TelemetryStore::aggregate(const Table& table) {
+    FleetHealth h;
+
+    int16_t maxTemperature = INVALID_TEMPERATURE;
+    for (int i = 0; i < MAX_DEVICES; i++) {
+        maxTemperature = table.temperature[i] > maxTemperature ? table.temperature[i] : maxTemperature;
+    }
+
+    uint16_t minVoltage = INVALID_VOLTAGE;
+    for (int i = 0; i < MAX_DEVICES; i++) {
+        minVoltage = table.voltage[i] < minVoltage ? table.voltage[i] : minVoltage;
+    }
+
+    uint32_t totalCurrent = 0;
+    for (int i = 0; i < MAX_DEVICES; i++) {
+        totalCurrent += table.current[i];
+    }
+
+    int32_t maxAbsIq = 0;
+    for (int i = 0; i < MAX_DEVICES; i++) {
+        int32_t iq = table.iq[i] < 0 ? -static_cast<int32_t>(table.iq[i]) : table.iq[i];
+        maxAbsIq = iq > maxAbsIq ? iq : maxAbsIq;
+    }
+
+    uint64_t errorMask = 0;
+    for (int i = 0; i < MAX_DEVICES; i++) {
+        errorMask |= static_cast<uint64_t>(table.errorState[i] != 0) << i;
+    }
+
+    h.maxTemperature = maxTemperature;
+    h.minVoltage = minVoltage;
+    h.totalCurrent = totalCurrent;
+    h.maxAbsIq = maxAbsIq;
+    h.errorMask = errorMask;
+    h.deviceCount = __builtin_popcountll(table.status1Mask);
+    return h;
+}
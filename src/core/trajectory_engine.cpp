@@ -0,0 +1,190 @@
+/**
+ * @file trajectory_engine.cpp
+ * @brief 位置轨迹下发引擎实现文件
+ * @details 周期由 ControlLoop 驱动，每个周期取一个路点以 postCommand 发出，不等待响应；
+ *          响应（状态2布局）由 CAN 接收线程解析进遥测
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "trajectory_engine.h"
+#include "logger.h"
+#include <algorithm>
+
+/**
+ * @brief TrajectoryEngine构造函数
+ * @param device 目标电机
+ * @param rateHz 设定值下发频率(Hz)
+ * @param capacity 单条轨迹最多路点数，两个缓冲区各按此容量预分配
+ */
+TrajectoryEngine::TrajectoryEngine(CANDevice& device, double rateHz, size_t capacity)
+    : device_(device), period_ns_(static_cast<int64_t>(1e9 / rateHz)), capacity_(capacity),
+      active_(0), index_(0), pending_(false), preempt_(false), finished_(true),
+      loop_(ControlLoop::Options{period_ns_, 0, -1, false}),
+      ticks_(0), sendFailures_(0), swaps_(0), underruns_(0)
+{
+    for (auto& buffer : buffers_)
+    {
+        buffer.points.resize(capacity);
+        buffer.count = 0;
+        buffer.loop = false;
+    }
+    loop_.addTask("trajectory_engine", [this](int64_t) { step(); });
+}
+
+TrajectoryEngine::~TrajectoryEngine()
+{
+    stop();
+}
+
+bool TrajectoryEngine::start()
+{
+    return loop_.start();
+}
+
+void TrajectoryEngine::stop()
+{
+    loop_.stop();
+}
+
+/**
+ * @brief 装载轨迹到后台缓冲区
+ * @details 默认在当前轨迹最后一个路点下发后的下一个周期切换；preempt 为 true 时在下一个周期立即切换。
+ *          切换前再次装载会覆盖尚未生效的轨迹
+ * @param points 路点数组
+ * @param count 路点数
+ * @param loop 是否循环执行（直到装载新的轨迹或取消）
+ * @param preempt 是否打断当前轨迹
+ * @return bool 装载成功返回true，为空或超出容量返回false
+ */
+bool TrajectoryEngine::load(const Waypoint* points, size_t count, bool loop, bool preempt)
+{
+    if (count == 0 || count > capacity_)
+    {
+        LOG_ERROR("轨迹路点数无效: " + std::to_string(count) + " (容量: " + std::to_string(capacity_) + ")");
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Buffer& back = buffers_[1 - active_];
+    std::copy(points, points + count, back.points.begin());
+    back.count = count;
+    back.loop = loop;
+    pending_ = true;
+    preempt_ = preempt;
+    return true;
+}
+
+bool TrajectoryEngine::load(const std::vector<Waypoint>& points, bool loop, bool preempt)
+{
+    return load(points.data(), points.size(), loop, preempt);
+}
+
+/**
+ * @brief 取消当前与待切换的轨迹，电机停在最后下发的设定值
+ */
+void TrajectoryEngine::cancel()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_ = false;
+    finished_ = true;
+}
+
+/**
+ * @brief 当前没有正在执行或等待切换的轨迹
+ */
+bool TrajectoryEngine::isIdle() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return finished_ && !pending_;
+}
+
+size_t TrajectoryEngine::getIndex() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_;
+}
+
+TrajectoryEngine::TrajectoryStats TrajectoryEngine::getStats() const
+{
+    return {ticks_.load(), loop_.getStats().missedPeriods, sendFailures_.load(), swaps_.load(), underruns_.load()};
+}
+
+/**
+ * @brief 取出本周期要下发的路点，必要时切换缓冲区
+ * @param point 输出路点
+ * @return bool 有路点需要下发返回true
+ */
+bool TrajectoryEngine::nextSetpoint(Waypoint& point)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_ && (finished_ || preempt_))
+    {
+        active_ = 1 - active_;
+        index_ = 0;
+        pending_ = false;
+        finished_ = false;
+        swaps_++;
+    }
+    if (finished_)
+    {
+        return false;
+    }
+
+    const Buffer& buffer = buffers_[active_];
+    point = buffer.points[index_];
+    if (++index_ >= buffer.count)
+    {
+        if (buffer.loop)
+        {
+            // 循环轨迹在每圈结束处接受非抢占的切换，否则从头再来
+            index_ = 0;
+            if (pending_)
+            {
+                active_ = 1 - active_;
+                pending_ = false;
+                swaps_++;
+            }
+        }
+        else
+        {
+            finished_ = true;
+            if (!pending_)
+            {
+                underruns_++;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 由外部周期执行器下发本周期的路点
+ * @details 自身下发线程已在运行时不下发，避免同一周期取两个路点
+ * @note 调用频率应与构造时的频率一致
+ * @return bool 已推进返回true
+ */
+bool TrajectoryEngine::tick()
+{
+    if (loop_.isRunning())
+    {
+        return false;
+    }
+    step();
+    return true;
+}
+
+// 下发本周期的路点
+void TrajectoryEngine::step()
+{
+    Waypoint point;
+    if (!nextSetpoint(point))
+    {
+        return;
+    }
+    MotorFrame frame = point.maxSpeed != 0 ? MotorCodec::MultiPositionControl2::encode(point.maxSpeed, point.angle)
+                                           : MotorCodec::MultiPositionControl1::encode(point.angle);
+    if (!device_.postCommand(frame))
+    {
+        sendFailures_++;
+    }
+    ticks_++;
+}
@@ -8,13 +8,22 @@
  */
 #include "can_device.h"
 #include "can_device_config.h"
+#include "telemetry_store.h"
+#include "binary_logger.h"
+#include "device_event_bus.h"
+
+// 当前线程最近一次命令是否被总线负载调节器限流
+static thread_local bool t_last_throttled = false;
 
 /**
  * @brief CANDevice构造函数
  * @param id 设备唯一标识符
  * @details 初始化CAN设备，设置设备类型为"CAN"
  */
-CANDevice::CANDevice(const std::string &id) : Device(id, "CAN"), can_interface_(nullptr)
+CANDevice::CANDevice(const std::string &id)
+    : Device(id, PROTOCOL), can_interface_(nullptr), node_(getDeviceIdFromString(id)), telemetry_slot_(-1), last_alive_(false),
+      reply_seq_{}, reply_time_ns_{}, inflight_{}, flight_throttled_{},
+      read_cache_ttl_ns_(static_cast<int64_t>(CAN_READ_CACHE_TTL_MS) * 1000000), last_error_state_(0)
 {
     LOG_INFO(" 创建 CAN 设备: [" + id + "]");
     heartbeat = std::make_unique<DeviceHeartbeat>(this);
@@ -59,9 +68,73 @@ bool CANDevice::disconnect()
     return true;
 }
 
+/**
+ * @brief CANDevice析构函数
+ * @details 注销接收回调，保证接收线程不再访问已销毁的设备
+ */
+CANDevice::~CANDevice()
+{
+    if (can_interface_)
+    {
+        can_interface_->removeReceiver(0x140 + node_);
+    }
+    if (heartbeat)
+    {
+        heartbeat->stop();
+    }
+    TelemetryStore::getInstance().clear(telemetry_slot_);
+}
+
+/**
+ * @brief 设置本电机在 TelemetryStore 中的行
+ * @details 由 DeviceManager 在分配设备句柄时调用，应在 setInterface 之前；
+ *          更换行时清除原来的行
+ * @param slot 设备句柄表下标，-1 表示不写入全车遥测表
+ */
+void CANDevice::setTelemetrySlot(int slot)
+{
+    if (telemetry_slot_ != slot)
+    {
+        TelemetryStore::getInstance().clear(telemetry_slot_);
+    }
+    telemetry_slot_ = slot;
+}
+
+/**
+ * @brief 设置CAN接口
+ * @details 通用入口，接口类型在运行期检查；已知接口类型时直接调用 setInterface(CANInterface&)
+ * @param interface 设备接口，必须为CANInterface类型
+ */
+void CANDevice::setInterface(Interface &interface)
+{
+    CANInterface *can_iface = dynamic_cast<CANInterface *>(&interface);
+    if (can_iface)
+    {
+        setInterface(*can_iface);
+    }
+    else
+    {
+        LOG_ERROR("设备 " + getId() + " 接口类型不匹配，需要CANInterface类型");
+    }
+}
+
+/**
+ * @brief 设置CAN接口
+ * @details 保存接口指针并向接口注册本设备 CAN ID 的接收回调
+ * @param interface CAN接口
+ */
+void CANDevice::setInterface(CANInterface &interface)
+{
+    this->can_interface_ = &interface;
+    can_interface_->addReceiver(0x140 + node_, [this](const struct can_frame &frame) {
+        onFrame(frame);
+    });
+    LOG_DEBUG("设备 " + getId() + " 接口为：" + this->can_interface_->interface_());
+}
+
 /**
  * @brief 发送命令到CAN设备
- * @details 发送CAN帧并等待响应
+ * @details 发送CAN帧并等待接收线程分发的响应
  * @param command 要发送的命令
  * @param data 附加数据（可选）
  * @param response_cmd 期望的响应命令（默认为0，表示使用发送的命令作为响应）
@@ -74,60 +147,214 @@ bool CANDevice::disconnect()
  */
 bool CANDevice::sendCommand(uint8_t command, const uint8_t *data, uint8_t response_cmd, uint32_t timeout_ms)
 {
-    struct can_frame frame;
-
-    frame.can_id = 0x140 + getDeviceIdFromString(id); // 标准帧 ID
-    frame.can_dlc = 8;                                // 数据长度固定8字节
-
-    frame.data[0] = command;
-    for (int i = 1; i < 8; i++)
+    if (response_cmd == 0)
     {
-        frame.data[i] = data ? data[i-1] : 0x00; // 修复索引偏移问题
+        response_cmd = command; // 如果没有指定响应命令，则使用发送的命令作为响应命令
+    }
+    if (response_cmd == command && data == nullptr && classifyCommand(command) == FrameClass::TELEMETRY)
+    {
+        return readCommand(command, timeout_ms);
     }
 
-    if (!can_interface_ || !can_interface_->send_frame(frame))
+    // 发送前记录响应序号，避免响应先于等待到达而被漏掉
+    uint32_t seq = replySequence(response_cmd);
+    auto start_time = std::chrono::steady_clock::now();
+    if (!postCommand(command, data))
     {
-        return false; // 发送失败
+        return false;
     }
-    LOG_DEBUG("命令 0x" + std::to_string(command) + " 发送成功。");
 
-    if (response_cmd == 0)
+    std::unique_lock<std::mutex> lock(reply_mutex_);
+    bool replied = reply_cv_.wait_until(lock, start_time + std::chrono::milliseconds(timeout_ms), [&]() {
+        return reply_seq_[response_cmd] != seq;
+    });
+    lock.unlock();
+
+    auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+    if (!replied)
     {
-        response_cmd = command; // 如果没有指定响应命令，则使用发送的命令作为响应命令
+        LOG_ERROR("等待命令响应超时: 0x" + std::to_string(response_cmd) + " after " + std::to_string(elapsed_time) + " ms");
+        DeviceEventBus::getInstance().postTimeout(id, response_cmd);
+        return false;
     }
-    // 记录当前时间
+    BLOG(DEBUG, "命令 0x%02X 接收成功。等待响应时间: %d ms", response_cmd, elapsed_time);
+    return true; // 发送和接收都成功
+}
+
+/**
+ * @brief 读取类命令的单飞（single-flight）发送
+ * @details 同一设备同一读取命令：
+ *          - 缓存未过期（距上次响应不超过 TTL）时直接返回，不占用总线
+ *          - 已有请求在途时不再发帧，等待同一个响应
+ *          - 否则由当前线程发出请求，响应到达后唤醒所有等待者
+ * @param command 读取命令
+ * @param timeout_ms 超时时间(毫秒)
+ * @return bool 取得有效数据返回true，超时或被限流返回false
+ */
+bool CANDevice::readCommand(uint8_t command, uint32_t timeout_ms)
+{
     auto start_time = std::chrono::steady_clock::now();
-    // 循环检查是否收到响应
-    while (true)
+    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(start_time.time_since_epoch()).count();
+
+    std::unique_lock<std::mutex> lock(reply_mutex_);
+    if (reply_seq_[command] != 0 && now_ns - reply_time_ns_[command] <= read_cache_ttl_ns_)
     {
-        auto current_time = std::chrono::steady_clock::now();
-        auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - start_time).count();
+        return true; // 缓存命中
+    }
 
-        // 超时检查
-        if (elapsed_time >= timeout_ms)
+    uint32_t seq = reply_seq_[command];
+    bool leader = !inflight_[command];
+    if (leader)
+    {
+        inflight_[command] = true;
+        lock.unlock();
+        bool sent = postCommand(command);
+        lock.lock();
+        if (!sent)
         {
-            LOG_ERROR("等待命令响应超时: 0x" + std::to_string(response_cmd) + " after " + std::to_string(elapsed_time) + " ms");
+            flight_throttled_[command] = t_last_throttled;
+            inflight_[command] = false;
+            reply_cv_.notify_all();
             return false;
         }
+    }
 
-        if (can_interface_ && can_interface_->receive_frame(frame, 50)) // 每50ms检查一次
-        {
-            // 获取接收到帧时的时间并重新计算
-            current_time = std::chrono::steady_clock::now();
-            elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - start_time).count();
+    bool replied = reply_cv_.wait_until(lock, start_time + std::chrono::milliseconds(timeout_ms), [&]() {
+        return reply_seq_[command] != seq || !inflight_[command];
+    });
+    replied = reply_seq_[command] != seq;
+    if (leader)
+    {
+        inflight_[command] = false;
+        flight_throttled_[command] = false;
+        reply_cv_.notify_all();
+    }
+    else if (!replied)
+    {
+        t_last_throttled = flight_throttled_[command];
+    }
+    lock.unlock();
 
-            // 检查返回的帧是否正确
-            if (frame.can_id == (0x140 + getDeviceIdFromString(id)) && frame.data[0] == response_cmd)
+    auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+    if (!replied)
+    {
+        if (!t_last_throttled)
+        {
+            LOG_ERROR("等待命令响应超时: 0x" + std::to_string(command) + " after " + std::to_string(elapsed_time) + " ms");
+            if (leader)
             {
-                LOG_DEBUG("命令 0x" + std::to_string(response_cmd) + " 接收成功。等待响应时间: " + std::to_string(elapsed_time) + " ms");
-#if CAN_DEVICE_HANDLE_RESPONSE_ENABLE
-                // 解析返回数据
-                handleResponse(frame);
-#endif
-                return true; // 发送和接收都成功
+                DeviceEventBus::getInstance().postTimeout(id, command); // 共享同一请求的等待者只报告一次
             }
         }
+        return false;
+    }
+    BLOG(DEBUG, "命令 0x%02X 接收成功(共享在途请求: %d)。等待响应时间: %d ms", command, !leader, elapsed_time);
+    return true;
+}
+
+/**
+ * @brief 获取遥测快照
+ * @details 无锁读取，不阻塞接收线程的写入；可在任意线程高频调用
+ * @return MotorTelemetry 一致的遥测数据拷贝，各字段附带最近更新时间，未收到过的字段时间为0
+ */
+MotorTelemetry CANDevice::getTelemetry() const
+{
+    return telemetry_.load();
+}
+
+/**
+ * @brief 设置读取缓存有效期
+ * @details 距上次收到某读取命令响应不超过该时间时，再次读取直接使用已解析的数据；
+ *          设为0则每次读取都访问总线（仍合并并发的相同请求）
+ * @param ttl_ms 有效期(毫秒)
+ */
+void CANDevice::setReadCacheTtl(uint32_t ttl_ms)
+{
+    std::lock_guard<std::mutex> lock(reply_mutex_);
+    read_cache_ttl_ns_ = static_cast<int64_t>(ttl_ms) * 1000000;
+}
+
+/**
+ * @brief 构造发往本设备的命令帧
+ * @param command 命令
+ * @param data 附加数据（可选），7字节，data[i-1] 对应帧 data[i]
+ * @param frame 输出帧
+ */
+void CANDevice::buildFrame(uint8_t command, const uint8_t *data, struct can_frame &frame) const
+{
+    frame.can_id = 0x140 + node_; // 标准帧 ID
+    frame.can_dlc = 8;            // 数据长度固定8字节
+
+    frame.data[0] = command;
+    for (int i = 1; i < 8; i++)
+    {
+        frame.data[i] = data ? data[i-1] : 0x00; // 修复索引偏移问题
+    }
+}
+
+/**
+ * @brief 发送命令但不等待响应
+ * @details 响应由接收线程分发到 onFrame 处理，可通过 replySequence 判断是否已收到；
+ *          用于轮询调度器在一个周期内连续发出多个请求，使各自的响应在总线上重叠
+ * @param command 要发送的命令
+ * @param data 附加数据（可选，7字节，对应帧的 data[1]~data[7]）
+ * @return bool 发送成功返回true，被限流或发送失败返回false
+ */
+bool CANDevice::postCommand(uint8_t command, const uint8_t *data)
+{
+    struct can_frame frame;
+    buildFrame(command, data, frame);
+
+    if (!can_interface_)
+    {
+        return false;
+    }
+    // 遥测帧需通过总线负载调节器，控制帧始终放行
+    t_last_throttled = !can_interface_->governor().admit(node_, classifyCommand(command));
+    if (t_last_throttled)
+    {
+        BLOG(DEBUG, "命令 0x%02X 被总线负载调节器限流。", command);
+        return false;
+    }
+    if (!can_interface_->send_frame(frame))
+    {
+        return false; // 发送失败
+    }
+    BLOG(DEBUG, "发送 [0x%03X] 原始数据: %02X %02X %02X %02X %02X %02X %02X %02X", frame.can_id,
+         frame.data[0], frame.data[1], frame.data[2], frame.data[3], frame.data[4], frame.data[5], frame.data[6], frame.data[7]);
+    return true;
+}
+
+/**
+ * @brief 获取某一命令的响应序号
+ * @details 每收到一帧该命令的响应序号加一
+ * @param command 响应命令字节
+ * @return uint32_t 当前序号
+ */
+uint32_t CANDevice::replySequence(uint8_t command) const
+{
+    std::lock_guard<std::mutex> lock(reply_mutex_);
+    return reply_seq_[command];
+}
+
+/**
+ * @brief 接收线程回调
+ * @details 解析响应数据并唤醒等待该命令响应的线程
+ * @param frame 收到的CAN帧
+ */
+void CANDevice::onFrame(const struct can_frame &frame)
+{
+#if CAN_DEVICE_HANDLE_RESPONSE_ENABLE
+    // 解析返回数据
+    handleResponse(frame);
+#endif
+    {
+        std::lock_guard<std::mutex> lock(reply_mutex_);
+        reply_seq_[frame.data[0]]++;
+        reply_time_ns_[frame.data[0]] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
     }
+    reply_cv_.notify_all();
 }
 
 bool CANDevice::motorCtrl(MOTOR_COMMAND cmd)
@@ -152,7 +379,8 @@ bool CANDevice::motorGetStatus(MOTOR_COMMAND cmd)
 
 bool CANDevice::motorSyncBrake(BRAKE_CMD cmd)
 {
-    return sendCommand(MOTOR_SYNC_BRAKE, reinterpret_cast<const uint8_t *>(&cmd));
+    MotorFrame frame = MotorCodec::SyncBrake::encode(cmd);
+    return sendCommand(frame[0], frame.data() + 1);
 }
 
 bool CANDevice::motorGetPosition(MOTOR_COMMAND cmd)
@@ -182,10 +410,8 @@ bool CANDevice::motorTorqueFeedbackControl(int16_t iqControl)
         return false;
     }
 
-    uint8_t data[8];
-    data[4] = static_cast<uint8_t>(iqControl & 0xFF);        // 低字节
-    data[5] = static_cast<uint8_t>((iqControl >> 8) & 0xFF); // 高字节
-    return sendCommand(MOTOR_TORQUE_FEEDBACK_CONTROL, data);
+    MotorFrame frame = MotorCodec::TorqueControl::encode(iqControl);
+    return sendCommand(frame[0], frame.data() + 1);
 }
 
 /**
@@ -199,138 +425,295 @@ bool CANDevice::motorTorqueFeedbackControl(int16_t iqControl)
  */
 bool CANDevice::motorSpeedFeedbackControl(int32_t speedControl)
 {
-    uint8_t data[8];
-    data[4] = static_cast<uint8_t>(speedControl & 0xFF);         // 低字节
-    data[5] = static_cast<uint8_t>((speedControl >> 8) & 0xFF);  // 次低字节
-    data[6] = static_cast<uint8_t>((speedControl >> 16) & 0xFF); // 次高字节
-    data[7] = static_cast<uint8_t>((speedControl >> 24) & 0xFF); // 高字节
-    return sendCommand(MOTOR_SPEED_FEEDBACK_CONTROL, data);
+    MotorFrame frame = MotorCodec::SpeedControl::encode(speedControl);
+    return sendCommand(frame[0], frame.data() + 1);
 }
 
 /**
- * @brief 检查CAN设备是否存活
- * @details 实现心跳检测逻辑
- * @return bool 设备存活返回true，未存活返回false
+ * @brief 多圈位置闭环控制（0xA3）
+ * @param angleControl 目标多圈角度，0.01°/LSB，正值顺时针
+ * @return bool 收到响应返回true
+ * @note 最大速度由上位机中的Max Speed值限制
  */
-bool CANDevice::checkDeviceAlive()
+bool CANDevice::motorMultiPositionControl(int32_t angleControl)
 {
-    bool isAlive = true;
+    MotorFrame frame = MotorCodec::MultiPositionControl1::encode(angleControl);
+    return sendCommand(frame[0], frame.data() + 1);
+}
 
-    // 输出检查结果
-    if (!motorGetStatus(MOTOR_GET_STATUS1))
+/**
+ * @brief 带速度限制的多圈位置闭环控制（0xA4）
+ * @param angleControl 目标多圈角度，0.01°/LSB，正值顺时针
+ * @param maxSpeed 最大转速，1dps/LSB
+ * @return bool 收到响应返回true
+ */
+bool CANDevice::motorMultiPositionControl(int32_t angleControl, uint16_t maxSpeed)
+{
+    MotorFrame frame = MotorCodec::MultiPositionControl2::encode(maxSpeed, angleControl);
+    return sendCommand(frame[0], frame.data() + 1);
+}
+
+/**
+ * @brief 单圈位置闭环控制（0xA5）
+ * @param spinDirection 旋转方向
+ * @param angleControl 目标单圈角度，0.01°/LSB，范围0~35999
+ * @return bool 收到响应返回true，角度越界返回false
+ */
+bool CANDevice::motorSinglePositionControl(SPIN_DIRECTION spinDirection, uint32_t angleControl)
+{
+    if (angleControl > 35999)
     {
-        isAlive = false;
-        LOG_ERROR("设备 " + id + " 未响应状态1请求，可能已断开连接或故障。");
+        LOG_ERROR("单圈位置控制值超出范围: " + std::to_string(angleControl));
+        return false;
     }
-    else
+    MotorFrame frame = MotorCodec::SinglePositionControl1::encode(spinDirection, angleControl);
+    return sendCommand(frame[0], frame.data() + 1);
+}
+
+/**
+ * @brief 带速度限制的单圈位置闭环控制（0xA6）
+ * @param spinDirection 旋转方向
+ * @param angleControl 目标单圈角度，0.01°/LSB，范围0~35999
+ * @param maxSpeed 最大转速，1dps/LSB
+ * @return bool 收到响应返回true，角度越界返回false
+ */
+bool CANDevice::motorSinglePositionControl(SPIN_DIRECTION spinDirection, uint32_t angleControl, uint16_t maxSpeed)
+{
+    if (angleControl > 35999)
     {
-        LOG_DEBUG("设备 " + id + " 状态1检查通过。");
+        LOG_ERROR("单圈位置控制值超出范围: " + std::to_string(angleControl));
+        return false;
     }
-    if (!motorGetStatus(MOTOR_GET_STATUS2))
+    MotorFrame frame = MotorCodec::SinglePositionControl2::encode(spinDirection, maxSpeed, angleControl);
+    return sendCommand(frame[0], frame.data() + 1);
+}
+
+/**
+ * @brief 增量位置闭环控制（0xA7）
+ * @param angleIncrement 相对当前位置的角度增量，0.01°/LSB，正值顺时针
+ * @return bool 收到响应返回true
+ */
+bool CANDevice::motorIncrementalPositionControl(int32_t angleIncrement)
+{
+    MotorFrame frame = MotorCodec::IncrementalPositionControl1::encode(angleIncrement);
+    return sendCommand(frame[0], frame.data() + 1);
+}
+
+/**
+ * @brief 带速度限制的增量位置闭环控制（0xA8）
+ * @param angleIncrement 相对当前位置的角度增量，0.01°/LSB，正值顺时针
+ * @param maxSpeed 最大转速，1dps/LSB
+ * @return bool 收到响应返回true
+ */
+bool CANDevice::motorIncrementalPositionControl(int32_t angleIncrement, uint16_t maxSpeed)
+{
+    MotorFrame frame = MotorCodec::IncrementalPositionControl2::encode(maxSpeed, angleIncrement);
+    return sendCommand(frame[0], frame.data() + 1);
+}
+
+/**
+ * @brief 检查CAN设备是否存活
+ * @details 实现心跳检测逻辑
+ *          被总线负载调节器限流的状态读取不视为设备无响应，
+ *          全部被限流时沿用上一次的检测结果
+ * @return bool 设备存活返回true，未存活返回false
+ */
+bool CANDevice::checkDeviceAlive()
+{
+    static const MOTOR_COMMAND polls[] = {MOTOR_GET_STATUS1, MOTOR_GET_STATUS2, MOTOR_GET_STATUS3};
+
+    bool isAlive = true;
+    int answered = 0;
+    for (int i = 0; i < 3; i++)
     {
-        isAlive = false;
-        LOG_ERROR("设备 " + id + " 未响应状态2请求，可能已断开连接或故障。");
+        if (motorGetStatus(polls[i]))
+        {
+            answered++;
+            LOG_DEBUG("设备 " + id + " 状态" + std::to_string(i + 1) + "检查通过。");
+        }
+        else if (t_last_throttled)
+        {
+            LOG_DEBUG("设备 " + id + " 状态" + std::to_string(i + 1) + "读取被限流，跳过。");
+        }
+        else
+        {
+            isAlive = false;
+            LOG_ERROR("设备 " + id + " 未响应状态" + std::to_string(i + 1) + "请求，可能已断开连接或故障。");
+        }
     }
-    else
+
+    if (isAlive && answered == 0)
     {
-        LOG_DEBUG("设备 " + id + " 状态2检查通过。");
+        return last_alive_;
     }
-    if (!motorGetStatus(MOTOR_GET_STATUS3))
+    last_alive_ = isAlive;
+    return isAlive;
+}
+
+/**
+ * @brief 判断命令所属的帧类别
+ * @details 状态与位置读取为遥测帧，其余命令为控制帧
+ * @param command 命令字节
+ * @return FrameClass 帧类别
+ */
+FrameClass CANDevice::classifyCommand(uint8_t command)
+{
+    switch (command)
     {
-        isAlive = false;
-        LOG_ERROR("设备 " + id + " 未响应状态3请求，可能已断开连接或故障。");
+    case MOTOR_GET_MULTI_POSITION:
+    case MOTOR_GET_SINGLE_POSITION:
+    case MOTOR_GET_STATUS1:
+    case MOTOR_GET_STATUS2:
+    case MOTOR_GET_STATUS3:
+        return FrameClass::TELEMETRY;
+    default:
+        return FrameClass::CONTROL;
     }
-    else
+}
+
+/**
+ * @brief 解析响应帧
+ * @details 按命令字节在编译期生成的响应布局表中查找布局，再按布局表调用对应的解析函数，不经过运行期 switch
+ * @param frame 收到的CAN帧
+ */
+void CANDevice::handleResponse(const can_frame &frame)
+{
+    using Handler = void (CANDevice::*)(const struct can_frame &, int64_t);
+    static constexpr std::array<Handler, static_cast<size_t>(MotorReplyLayout::COUNT)> handlers = {
+        nullptr,                          // NONE
+        &CANDevice::onAck,                // ACK
+        &CANDevice::onBrake,              // BRAKE
+        &CANDevice::onStatus1,            // STATUS1
+        &CANDevice::onStatus2,            // STATUS2
+        &CANDevice::onStatus3,            // STATUS3
+        &CANDevice::onMultiPosition,      // MULTI_POSITION
+        &CANDevice::onSinglePosition,     // SINGLE_POSITION
+    };
+    static_assert(static_cast<size_t>(MotorReplyLayout::SINGLE_POSITION) == handlers.size() - 1, "响应解析表与布局不一致");
+
+    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    // 原始数据写入二进制日志，现场可常开
+    BLOG(DEBUG, "接收 [0x%03X] 原始数据: %02X %02X %02X %02X %02X %02X %02X %02X", frame.can_id,
+         frame.data[0], frame.data[1], frame.data[2], frame.data[3], frame.data[4], frame.data[5], frame.data[6], frame.data[7]);
+
+    Handler handler = handlers[static_cast<size_t>(motorReplyLayout(frame.data[0]))];
+    if (!handler)
     {
-        LOG_DEBUG("设备 " + id + " 状态3检查通过。");
+        LOG_WARNING("未解析: " + std::to_string(frame.data[0]));
+        return;
     }
+    (this->*handler)(frame, now_ns);
+}
 
-    return isAlive;
+/**
+ * @brief 生成遥测样本的公共字段，负载字段由各解析函数填写后发布
+ */
+MotorSample CANDevice::makeSample(MotorReplyLayout layout, const struct can_frame &frame, int64_t now_ns)
+{
+    MotorSample sample;
+    std::memset(&sample, 0, sizeof(sample));
+    sample.layout = layout;
+    sample.command = frame.data[0];
+    sample.timestamp_ns = now_ns;
+    return sample;
 }
 
-void CANDevice::handleResponse(const can_frame &frame)
+void CANDevice::onAck(const struct can_frame &frame, int64_t)
 {
-    uint8_t status_code = frame.data[0];
-    
-    // 添加原始数据调试输出
-    std::string raw_data = "原始数据: ";
-    for (int i = 0; i < 8; i++) {
-        char hex_str[4];
-        std::sprintf(hex_str, "%02X ", frame.data[i]);
-        raw_data += hex_str;
-    }
-    LOG_DEBUG(raw_data);
-    
-    switch (status_code)
+    BLOG(DEBUG, "命令 0x%02X 已确认", frame.data[0]);
+}
+
+void CANDevice::onBrake(const struct can_frame &frame, int64_t now_ns)
+{
+    uint8_t state = BrakeReply::decode(frame.data);
+    BLOG(DEBUG, "抱闸器状态: %d (0=刹车 1=释放)", state);
+    MotorSample sample = makeSample(MotorReplyLayout::BRAKE, frame, now_ns);
+    sample.brake = state;
+    telemetry_ring_.publish(sample);
+}
+
+void CANDevice::onStatus1(const struct can_frame &frame, int64_t now_ns)
+{
+    Status1_t status1 = Status1Reply::decode(frame.data);
+    BLOG(DEBUG, "读取状态1: 电机温度 %d℃, 母线电压 %d (0.01V), 母线电流 %d (0.01A), 电机状态 0x%02X, 错误状态 0x%02X",
+         status1.temperature, status1.voltage, status1.current, status1.motorState, status1.errorState);
+    telemetry_.write([&](MotorTelemetry &t) {
+        t.status1 = status1;
+        t.status1_ns = now_ns;
+        t.timestamp_ns = now_ns;
+    });
+    TelemetryStore::getInstance().updateStatus1(telemetry_slot_, status1.temperature,
+                                                status1.voltage, status1.current, status1.errorState);
+    MotorSample sample = makeSample(MotorReplyLayout::STATUS1, frame, now_ns);
+    sample.status1 = status1;
+    telemetry_ring_.publish(sample);
+    if (status1.errorState != last_error_state_)
     {
-    case MOTOR_GET_STATUS1:
-        // 解析状态1数据
-        status1_.temperature = frame.data[1];
-        status1_.voltage = ((frame.data[3] << 8) | frame.data[2]);
-        status1_.current = ((frame.data[5] << 8) | frame.data[4]);
-        status1_.motorState = static_cast<MOTOR_STATE>(frame.data[6]);
-        status1_.errorState = frame.data[7];
-        char errorStateHex[10];
-        std::sprintf(errorStateHex, "0x%04X", static_cast<int>(status1_.errorState));
-        LOG_DEBUG("读取状态1: \n\t电机温度: " + std::to_string(status1_.temperature) + "℃"
-                                                                                       "\n\t母线电压: " +
-                  std::to_string(status1_.voltage * 0.01) + "V (原始值: " + std::to_string(status1_.voltage) + ")"
-                                                     "\n\t母线电流: " +
-                  std::to_string(status1_.current * 0.01) + "A (原始值: " + std::to_string(status1_.current) + ")"
-                                                     "\n\t电机状态: " +
-                  (status1_.motorState == MOTOR_STATE::OFF ? "关闭" : "开启") +
-                  "\n\t错误状态: " + errorStateHex);
-        break;
+        DeviceEventBus::getInstance().postErrorFlags(id, status1.errorState, last_error_state_);
+        last_error_state_ = status1.errorState;
+    }
+}
 
-    case MOTOR_GET_STATUS2:
-        // 解析状态2数据
-        status2_.temperature = frame.data[1];
-        status2_.current = (frame.data[3] << 8) | frame.data[2];
-        status2_.speed = (frame.data[5] << 8) | frame.data[4];
-        status2_.encoder = (frame.data[7] << 8) | frame.data[6];
-        LOG_DEBUG("读取状态2: \n\t电机温度: " + std::to_string(status2_.temperature) + "℃"
-                                                                                       "\n\t转矩电流: " +
-                  std::to_string(status2_.current * 66.0 / 4096.0) + "A (原始值: " + std::to_string(status2_.current) + ")"
-                                                     "\n\t电机速度: " +
-                  std::to_string(status2_.speed) + "dps"
-                                                   "\n\t编码器: " +
-                  std::to_string(status2_.encoder));
-        break;
+// 状态2，闭环控制命令的响应与状态2布局相同
+void CANDevice::onStatus2(const struct can_frame &frame, int64_t now_ns)
+{
+    Status2_t status2 = Status2Reply::decode(frame.data);
+    BLOG(DEBUG, "读取状态2: 电机温度 %d℃, 转矩电流 %d (66/4096 A), 电机速度 %d dps, 编码器 %u",
+         status2.temperature, status2.current, status2.speed, status2.encoder);
+    telemetry_.write([&](MotorTelemetry &t) {
+        t.status2 = status2;
+        t.status2_ns = now_ns;
+        t.timestamp_ns = now_ns;
+    });
+    TelemetryStore::getInstance().updateStatus2(telemetry_slot_, status2.temperature,
+                                                status2.current, status2.speed, status2.encoder);
+    MotorSample sample = makeSample(MotorReplyLayout::STATUS2, frame, now_ns);
+    sample.status2 = status2;
+    telemetry_ring_.publish(sample);
+}
 
-    case MOTOR_GET_STATUS3:
-        // 解析状态3数据
-        status3_.temperature = frame.data[1];
-        status3_.current_A = (frame.data[3] << 8) | frame.data[2];
-        status3_.current_B = (frame.data[5] << 8) | frame.data[4];
-        status3_.current_C = (frame.data[7] << 8) | frame.data[6];
-        LOG_DEBUG("读取状态3: \n\t电机温度: " + std::to_string(status3_.temperature) + "℃"
-                                                                                       "\n\t电流A: " +
-                  std::to_string(status3_.current_A * 66.0 / 4096.0) + "A (原始值: " + std::to_string(status3_.current_A) + ")"
-                                                       "\n\t电流B: " +
-                  std::to_string(status3_.current_B * 66.0 / 4096.0) + "A (原始值: " + std::to_string(status3_.current_B) + ")"
-                                                       "\n\t电流C: " +
-                  std::to_string(status3_.current_C * 66.0 / 4096.0) + "A (原始值: " + std::to_string(status3_.current_C) + ")");
-        break;
-    case MOTOR_GET_MULTI_POSITION:
-        multi_position_ = 0;
-        for (int i = 1; i < 8; i++)
-        {
-            multi_position_ |= (static_cast<int64_t>(frame.data[i]) << ((i - 1) * 8));
-        }
-        LOG_DEBUG("读取多圈位置: " + std::to_string(multi_position_) + " (单位: 0.01°/LSB)");
-        break;
+void CANDevice::onStatus3(const struct can_frame &frame, int64_t now_ns)
+{
+    Status3_t status3 = Status3Reply::decode(frame.data);
+    BLOG(DEBUG, "读取状态3: 电机温度 %d℃, 相电流 A %d B %d C %d (66/4096 A)",
+         status3.temperature, status3.current_A, status3.current_B, status3.current_C);
+    telemetry_.write([&](MotorTelemetry &t) {
+        t.status3 = status3;
+        t.status3_ns = now_ns;
+        t.timestamp_ns = now_ns;
+    });
+    TelemetryStore::getInstance().updateTemperature(telemetry_slot_, status3.temperature);
+    MotorSample sample = makeSample(MotorReplyLayout::STATUS3, frame, now_ns);
+    sample.status3 = status3;
+    telemetry_ring_.publish(sample);
+}
 
-    case MOTOR_GET_SINGLE_POSITION:
-        single_position_ = 0;
-        single_position_ = (static_cast<uint32_t>(frame.data[4])) |
-                           (static_cast<uint32_t>(frame.data[5]) << 8) |
-                           (static_cast<uint32_t>(frame.data[6]) << 16) |
-                           (static_cast<uint32_t>(frame.data[7]) << 24);
-        LOG_DEBUG("读取单圈位置: " + std::to_string(single_position_) + " (单位: 0.01°/LSB, 范围: 0~36000*减速比-1)");
-        break;
+void CANDevice::onMultiPosition(const struct can_frame &frame, int64_t now_ns)
+{
+    int64_t multi_position = MultiPositionReply::decode(frame.data);
+    BLOG(DEBUG, "读取多圈位置: %d (单位: 0.01°/LSB)", multi_position);
+    telemetry_.write([&](MotorTelemetry &t) {
+        t.multi_position = multi_position;
+        t.multi_position_ns = now_ns;
+        t.timestamp_ns = now_ns;
+    });
+    MotorSample sample = makeSample(MotorReplyLayout::MULTI_POSITION, frame, now_ns);
+    sample.multi_position = multi_position;
+    telemetry_ring_.publish(sample);
+}
 
-    default:
-        LOG_WARNING("未解析: " + std::to_string(status_code));
-        break;
-    }
+void CANDevice::onSinglePosition(const struct can_frame &frame, int64_t now_ns)
+{
+    uint32_t single_position = SinglePositionReply::decode(frame.data);
+    BLOG(DEBUG, "读取单圈位置: %u (单位: 0.01°/LSB, 范围: 0~36000*减速比-1)", single_position);
+    telemetry_.write([&](MotorTelemetry &t) {
+        t.single_position = single_position;
+        t.single_position_ns = now_ns;
+        t.timestamp_ns = now_ns;
+    });
+    MotorSample sample = makeSample(MotorReplyLayout::SINGLE_POSITION, frame, now_ns);
+    sample.single_position = single_position;
+    telemetry_ring_.publish(sample);
 }
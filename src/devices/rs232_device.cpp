@@ -1,10 +1,23 @@
 #include "rs232_device.h"
+#include "device_event_bus.h"
+#include <sstream>
+#include <iomanip>
 
 // 构造函数
-RS232Device::RS232Device(const std::string& id) : Device(id, "RS232") {
+RS232Device::RS232Device(const std::string& id) : Device(id, PROTOCOL) {
     LOG_INFO("创建 RS232 设备: [" + id + "]");
 }
 
+// 析构函数：解除串口接收回调，避免事件循环访问已销毁的设备
+RS232Device::~RS232Device() {
+    if (heartbeat) {
+        heartbeat->stop();
+    }
+    if (deviceInterface) {
+        deviceInterface->setReceiver(nullptr);
+    }
+}
+
 // 连接设备
 bool RS232Device::connect() {
     LOG_INFO("正在连接 RS232 设备: [" + id + "]");
@@ -25,10 +38,178 @@ bool RS232Device::disconnect() {
     return true;
 }
 
-// 发送命令
+// 设置接口：只接受串口接口，接口类型在运行期检查
+void RS232Device::setInterface(Interface& interface) {
+    RS232Interface* serial = dynamic_cast<RS232Interface*>(&interface);
+    if (!serial) {
+        LOG_ERROR("RS232 设备 [" + id + "] 需要串口接口");
+        return;
+    }
+    setInterface(*serial);
+}
+
+// 设置串口接口并注册接收回调
+void RS232Device::setInterface(RS232Interface& interface) {
+    if (deviceInterface) {
+        deviceInterface->setReceiver(nullptr);
+    }
+    deviceInterface = &interface;
+    deviceInterface->setReceiver([this](const uint8_t* data, size_t length) {
+        onData(data, length);
+    });
+}
+
+/**
+ * @brief 发送命令并等待应答
+ * @param command LH08 功能码（LH08_QUERY / LH08_SET）
+ * @param data 设置命令的8路继电器状态(LH08_RELAY_STATE)，查询命令传 nullptr
+ * @param response_cmd 期望的应答功能码，0 表示与 command 相同
+ * @param timeout_ms 超时时间(毫秒)
+ * @return bool 在超时前收到校验正确的应答返回true
+ */
 bool RS232Device::sendCommand(uint8_t command, const uint8_t *data, uint8_t response_cmd, uint32_t timeout_ms) {
-    LOG_DEBUG("发送指令到 RS232 设备: [" + id + "] 命令: " + std::to_string(command));
-    // TODO: 实现 RS232 具体的命令发送逻辑
+    // 协议没有序号，同一时间只允许一个请求在途
+    std::lock_guard<std::mutex> request_lock(request_mutex_);
+    return sendCommandLocked(command, data, response_cmd, timeout_ms);
+}
+
+/**
+ * @brief 发送命令并等待应答的实现
+ * @note 调用者需持有 request_mutex_
+ */
+bool RS232Device::sendCommandLocked(uint8_t command, const uint8_t *data, uint8_t response_cmd, uint32_t timeout_ms) {
+    if (response_cmd == 0) {
+        response_cmd = command;
+    }
+    uint32_t seq;
+    {
+        std::lock_guard<std::mutex> lock(reply_mutex_);
+        seq = reply_seq_[response_cmd];
+    }
+    auto start_time = std::chrono::steady_clock::now();
+    if (!postCommand(command, data)) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(reply_mutex_);
+    bool replied = reply_cv_.wait_until(lock, start_time + std::chrono::milliseconds(timeout_ms), [&]() {
+        return reply_seq_[response_cmd] != seq;
+    });
+    lock.unlock();
+
+    auto elapsed_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+    if (!replied) {
+        // 超时的设置命令可能已被执行，继电器状态不再可信
+        relay_mask_known_.store(false, std::memory_order_release);
+        LOG_ERROR("RS232 设备 [" + id + "] 等待应答超时: 功能码 " + std::to_string(response_cmd));
+        DeviceEventBus::getInstance().postTimeout(id, response_cmd);
+        return false;
+    }
+    LOG_DEBUG("RS232 设备 [" + id + "] 功能码 " + std::to_string(response_cmd) + " 应答时间: " + std::to_string(elapsed_time) + " us");
     return true;
 }
 
+/**
+ * @brief 发送命令但不等待应答
+ * @param command LH08 功能码
+ * @param data 8路继电器状态，查询命令传 nullptr
+ * @return bool 已写出或进入发送缓存返回true
+ */
+bool RS232Device::postCommand(uint8_t command, const uint8_t *data) {
+    if (!deviceInterface) {
+        LOG_ERROR("RS232 设备 [" + id + "] 未设置接口");
+        return false;
+    }
+    uint8_t frame[LH08_FRAME_SIZE];
+    lh08EncodeFrame(command, command == LH08_SET ? data : nullptr, frame);
+    return deviceInterface->write(frame, sizeof(frame));
+}
+
+/**
+ * @brief 一次设置全部8路继电器
+ * @param mask 继电器状态位图，bit0 对应继电器1，置位为吸合
+ * @param timeout_ms 超时时间(毫秒)
+ * @return bool 收到应答返回true
+ */
+bool RS232Device::setRelays(uint8_t mask, uint32_t timeout_ms) {
+    uint8_t relays[LH08_RELAY_COUNT];
+    lh08RelayStates(mask, relays);
+    return sendCommand(LH08_SET, relays, LH08_SET, timeout_ms);
+}
+
+/**
+ * @brief 设置单路继电器，其余继电器保持最近一次应答中的状态
+ * @details 读取状态到发出设置命令之间持有 request_mutex_，并发修改不同继电器时不会互相覆盖；
+ *          尚未收到过应答或上一次请求超时时，先在同一把锁下查询一次，避免把其余继电器当作断开下发
+ * @param pos 继电器位置 1~8
+ * @param on true 吸合，false 断开
+ * @param timeout_ms 超时时间(毫秒)，查询与设置各自计时
+ * @return bool 收到应答返回true，状态未知且查询无应答返回false
+ */
+bool RS232Device::setRelay(int pos, bool on, uint32_t timeout_ms) {
+    if (pos < 1 || pos > LH08_RELAY_COUNT) {
+        LOG_WARNING("无效的继电器位置: " + std::to_string(pos) + "，范围: 1~8");
+        return false;
+    }
+    uint8_t bit = static_cast<uint8_t>(1u << (pos - 1));
+    std::lock_guard<std::mutex> request_lock(request_mutex_);
+    if (!relay_mask_known_.load(std::memory_order_acquire)) {
+        if (!sendCommandLocked(LH08_QUERY, nullptr, LH08_QUERY, timeout_ms)) {
+            LOG_ERROR("RS232 设备 [" + id + "] 继电器状态未知，放弃设置继电器 " + std::to_string(pos));
+            return false;
+        }
+    }
+    uint8_t mask = getRelayMask();
+    uint8_t relays[LH08_RELAY_COUNT];
+    lh08RelayStates(on ? (mask | bit) : (mask & ~bit), relays);
+    return sendCommandLocked(LH08_SET, relays, LH08_SET, timeout_ms);
+}
+
+/**
+ * @brief 查询继电器状态，结果通过 getRelayMask 获取
+ * @param timeout_ms 超时时间(毫秒)
+ * @return bool 收到应答返回true
+ */
+bool RS232Device::queryRelays(uint32_t timeout_ms) {
+    return sendCommand(LH08_QUERY, nullptr, LH08_QUERY, timeout_ms);
+}
+
+// 心跳：查询一次继电器状态
+bool RS232Device::checkDeviceAlive() {
+    return queryRelays();
+}
+
+/**
+ * @brief 串口数据回调（事件循环线程）
+ * @details 数据块可在任意位置截断或包含多帧，由流式分帧器拼帧、校验和重新同步
+ * @param data 收到的数据
+ * @param length 字节数
+ */
+void RS232Device::onData(const uint8_t* data, size_t length) {
+    parser_.feed(data, length, [this](const uint8_t* frame) {
+        handleFrame(frame);
+    });
+    checksum_errors_.store(parser_.getChecksumErrors(), std::memory_order_relaxed);
+}
+
+/**
+ * @brief 处理一帧校验正确的应答
+ * @param frame 13字节应答帧
+ */
+void RS232Device::handleFrame(const uint8_t* frame) {
+    uint8_t function = frame[3];
+    relay_mask_.store(lh08DecodeRelayMask(frame), std::memory_order_release);
+    relay_mask_known_.store(true, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(reply_mutex_);
+        reply_seq_[function]++;
+    }
+    reply_cv_.notify_all();
+
+    if (LOG_ENABLED(DEBUG)) {
+        std::stringstream ss;
+        ss << "RS232 设备 [" << id << "] 应答: 功能码 " << static_cast<int>(function)
+           << " 继电器 0x" << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(getRelayMask());
+        LOG_DEBUG(ss.str());
+    }
+}
@@ -1,13 +1,61 @@
 #include "control_center.h"
 #include "device_manager.h"
 #include "logger.h"
+#include "telemetry_store.h"
+#include "binary_logger.h"
+#include "alloc_counter.h"
 #include <iostream>
 #include <thread>
 #include <vector>
 #include <chrono>
 
+/**
+ * @brief 控制路径堆分配检查
+ * @details 以句柄反复读取状态2（不改变电机状态），预热后统计全进程的堆分配次数，稳态应为0；
+ *          检查期间关闭读取缓存，使每次读取都经过总线往返（被限流的读取不发帧，计入失败次数）；
+ *          需以 -DENABLE_ALLOC_COUNTER=ON 构建，否则计数恒为0。无硬件时见 tests/unit/alloc_path_test
+ * @param dm 设备管理器
+ * @param id 被测设备ID
+ * @return bool 预热后无堆分配返回true
+ */
+bool allocationCheck(DeviceManager& dm, const std::string& id) {
+    constexpr int WARMUP = 100;
+    constexpr int ROUNDS = 1000;
+    DeviceHandle handle = dm.getHandle(id);
+    if (!handle.valid()) {
+        std::cout << "设备未找到: " << id << "\n";
+        return false;
+    }
+    if (!AllocCounter::enabled()) {
+        std::cout << "未开启堆分配计数（ENABLE_ALLOC_COUNTER），结果无效\n";
+    }
+
+    CANDevice* motor = dm.getDeviceAs<CANDevice>(id);
+    if (motor) {
+        motor->setReadCacheTtl(0);
+    }
+
+    auto frame = MotorCodec::GetStatus2::encode();
+    for (int i = 0; i < WARMUP; i++) {
+        dm.sendCommand(handle, frame[0], nullptr);
+    }
+    int replied = 0;
+    AllocScope scope;
+    for (int i = 0; i < ROUNDS; i++) {
+        replied += dm.sendCommand(handle, frame[0], nullptr);
+    }
+    uint64_t allocations = scope.allocations();
+    if (motor) {
+        motor->setReadCacheTtl(CAN_READ_CACHE_TTL_MS);
+    }
+
+    std::cout << "命令 " << ROUNDS << " 次 (成功 " << replied << ")，堆分配 " << allocations << " 次: "
+              << (allocations == 0 ? "通过" : "未通过") << "\n";
+    return allocations == 0;
+}
+
 // 简单的终端控制界面
-void terminalControl(DeviceManager& dm, ControlCenter& cc) {
+void terminalControl(DeviceManager& dm, ControlCenter& cc, CANInterface& can) {
     while (true) {
         std::cout << "\nK2 控制器\n";
         std::cout << "1. 设备列表\n";
@@ -16,7 +64,8 @@ void terminalControl(DeviceManager& dm, ControlCenter& cc) {
         std::cout << "4. 切换日志输出 [当前: " 
                   << (Logger::getInstance().isConsoleOutputEnabled() ? "终端+文件" : "仅文件") 
                   << "]\n";
-        std::cout << "5. 退出\n";
+        std::cout << "5. 堆分配检查\n";
+        std::cout << "6. 退出\n";
         std::cout << "选择: ";
         
         int choice;
@@ -38,6 +87,15 @@ void terminalControl(DeviceManager& dm, ControlCenter& cc) {
                     }
                     std::cout << "]\n";
                 }
+                std::cout << "总线负载: " << static_cast<int>(can.getBusLoad() * 100) << "%"
+                          << " (遥测降频级别: " << can.governor().getShiftLevel()
+                          << ", 已限流: " << can.governor().getThrottledCount() << ")\n";
+                auto health = TelemetryStore::getInstance().health();
+                if (health.deviceCount > 0) {
+                    std::cout << "电机最高温度: " << health.maxTemperature << "℃"
+                              << ", 最低母线电压: " << health.minVoltage * 0.01 << "V"
+                              << ", 母线总电流: " << health.totalCurrent * 0.01 << "A\n";
+                }
                 break;
             }
             case 2: {
@@ -80,7 +138,14 @@ void terminalControl(DeviceManager& dm, ControlCenter& cc) {
                           << (!currentState ? "终端+文件" : "仅文件") << "\n";
                 break;
             }
-            case 5:
+            case 5: {
+                std::string deviceId;
+                std::cout << "输入设备id: ";
+                std::cin >> deviceId;
+                allocationCheck(dm, deviceId);
+                break;
+            }
+            case 6:
                 return;
             default:
                 std::cout << "无效选择\n";
@@ -91,6 +156,10 @@ void terminalControl(DeviceManager& dm, ControlCenter& cc) {
 int main() {
     // 初始化日志系统
     Logger::getInstance().setLogFile("logs/device_control.log");
+    // 日志由后台线程写出，避免阻塞 CAN 收发
+    Logger::getInstance().setAsync(true);
+    // CAN 帧级日志写入二进制文件，使用 blog_decode 查看
+    BinaryLogger::getInstance().open("logs/device_control.bin");
     LOG_INFO("K2 控制器启动...");
     
     // 创建设备管理器
@@ -103,29 +172,37 @@ int main() {
         return -1;
     }
     LOG_INFO("CAN接口初始化成功");
+
+    // 继电器板串口，打开失败时不影响电机控制
+    RS232Interface relayPort(LH08_SERIAL_PORT);
+    bool relayReady = relayPort.init();
+    if (!relayReady) {
+        LOG_WARNING("继电器串口初始化失败，跳过继电器设备");
+    }
     
     // 添加设备
-    deviceManager.addDevice("CAN", "motor_4", can0);
+    deviceManager.addDevice<CANDevice>("motor_4", can0);
     // deviceManager.addDevice("CAN", "motor2");
-    // deviceManager.addDevice("RS232", "relay");
+    if (relayReady) {
+        deviceManager.addDevice<RS232Device>("relay_1", relayPort);
+    }
     
     // 连接设备
     deviceManager.connectDevice("motor_4");
     // deviceManager.connectDevice("motor2");
-    // deviceManager.connectDevice("relay");
+    if (relayReady) {
+        deviceManager.connectDevice("relay_1");
+    }
     
     // 等待设备连接稳定
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
     
     // 发送速度控制命令让电机运行
-    int32_t speedControl = 100;
-    uint8_t data[8] = {0}; // 初始化所有元素为0
-    data[4] = static_cast<uint8_t>(speedControl & 0xFF);
-    data[5] = static_cast<uint8_t>((speedControl >> 8) & 0xFF);
-    data[6] = static_cast<uint8_t>((speedControl >> 16) & 0xFF);
-    data[7] = static_cast<uint8_t>((speedControl >> 24) & 0xFF);
-    LOG_INFO("发送速度控制命令: " + std::to_string(speedControl));
-    deviceManager.sendCommand("motor_4", MOTOR_SPEED_FEEDBACK_CONTROL, data);
+    DeviceHandle motor = deviceManager.getHandle("motor_4");
+    units::CentiDps speedControl(100);
+    auto speedFrame = MotorCodec::SpeedControl::encode(speedControl.raw());
+    LOG_INFO("发送速度控制命令: " + std::to_string(speedControl.value()) + " dps");
+    deviceManager.sendCommand(motor, speedFrame[0], speedFrame.data() + 1);
     
     // 等待一段时间让电机开始运行
     std::this_thread::sleep_for(std::chrono::milliseconds(500));
@@ -134,7 +211,7 @@ int main() {
     
     // 启动终端控制界面
     std::thread terminalThread([&]() {
-        terminalControl(deviceManager, controlCenter);
+        terminalControl(deviceManager, controlCenter, can0);
     });
     
     // 这里可以添加WebSocket和MQTT的初始化代码
@@ -142,11 +219,12 @@ int main() {
     
     terminalThread.join();
     
-    // 断开所有设备
+    // 断开并移除所有设备（设备持有接口指针，须先于 CAN/串口接口销毁）
     for (const auto& id : deviceManager.listDevices()) {
-        deviceManager.disconnectDevice(id);
+        deviceManager.removeDevice(id);
     }
     
     LOG_INFO("K2 控制器已关闭.");
+    Logger::getInstance().flush();
     return 0;
 }
\ No newline at end of file
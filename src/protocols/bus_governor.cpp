@@ -0,0 +1,129 @@
+/**
+ * @file bus_governor.cpp
+ * @brief CAN总线负载调节器实现文件
+ * @details 实现遥测帧令牌桶限流与按总线负载自动降频
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "bus_governor.h"
+#include "global_config.h"
+#include "logger.h"
+
+/**
+ * @brief BusGovernor构造函数
+ * @details 使用 global_config.h 中的默认速率与水位线初始化令牌桶
+ */
+BusGovernor::BusGovernor()
+    : deviceRate_(CAN_TELEMETRY_DEVICE_RATE),
+      busRate_(CAN_TELEMETRY_BUS_RATE),
+      highWatermark_(CAN_BUS_LOAD_HIGH_WATERMARK),
+      lowWatermark_(CAN_BUS_LOAD_LOW_WATERMARK),
+      shiftLevel_(0),
+      throttled_(0),
+      controlFrames_(0)
+{
+    // 桶容量取 100ms 的令牌量，允许心跳一次性读取多个状态
+    for (auto &bucket : deviceBuckets_) {
+        bucket = TokenBucket(deviceRate_, deviceRate_ * 0.1);
+    }
+    busBucket_ = TokenBucket(busRate_, busRate_ * 0.1);
+}
+
+/**
+ * @brief 判断一帧是否允许发送
+ * @details 控制帧直接放行；遥测帧需同时从设备令牌桶和总线令牌桶取得令牌
+ * @param node 设备节点号（电机ID）
+ * @param cls 帧类别
+ * @return bool 允许发送返回true，被限流返回false
+ */
+bool BusGovernor::admit(int node, FrameClass cls)
+{
+    if (cls == FrameClass::CONTROL) {
+        controlFrames_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (node > 0 && node < MAX_NODES && !deviceBuckets_[node].tryAcquire(now)) {
+        throttled_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (!busBucket_.tryAcquire(now)) {
+        throttled_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 根据总线负载调整降频级别
+ * @details 由 CANInterface 在每个统计窗口结束时调用
+ *          - 负载高于高水位：降频一级（遥测速率减半）
+ *          - 负载低于低水位：恢复一级
+ * @param load 当前总线利用率(0.0~1.0)
+ */
+void BusGovernor::onBusLoad(double load)
+{
+    int level;
+    int next;
+    {
+        // 水位线可由 setThresholds 在其它线程修改，与之在同一把锁下读取
+        std::lock_guard<std::mutex> lock(mutex_);
+        level = shiftLevel_.load(std::memory_order_relaxed);
+        next = level;
+        if (load > highWatermark_ && level < MAX_SHIFT_LEVEL) {
+            next = level + 1;
+        } else if (load < lowWatermark_ && level > 0) {
+            next = level - 1;
+        }
+        if (next == level) {
+            return;
+        }
+        shiftLevel_.store(next, std::memory_order_relaxed);
+        applyRates();
+    }
+    if (next > level) {
+        LOG_WARNING("总线负载 " + std::to_string(static_cast<int>(load * 100)) + "%，遥测降频至 1/" + std::to_string(1 << next));
+    } else {
+        LOG_INFO("总线负载 " + std::to_string(static_cast<int>(load * 100)) + "%，遥测恢复至 1/" + std::to_string(1 << next));
+    }
+}
+
+/**
+ * @brief 设置遥测基准速率
+ * @param perDeviceRate 每设备遥测速率(帧/秒)
+ * @param busRate 全总线遥测速率(帧/秒)
+ */
+void BusGovernor::setTelemetryRate(double perDeviceRate, double busRate)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    deviceRate_ = perDeviceRate;
+    busRate_ = busRate;
+    applyRates();
+}
+
+/**
+ * @brief 设置降频水位线
+ * @param high 高水位(0.0~1.0)
+ * @param low 低水位(0.0~1.0)，应小于高水位以避免来回切换
+ */
+void BusGovernor::setThresholds(double high, double low)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    highWatermark_ = high;
+    lowWatermark_ = low;
+}
+
+/**
+ * @brief 按当前降频级别更新所有令牌桶速率
+ * @note 调用者需持有 mutex_
+ */
+void BusGovernor::applyRates()
+{
+    double scale = 1.0 / (1 << shiftLevel_.load(std::memory_order_relaxed));
+    for (auto &bucket : deviceBuckets_) {
+        bucket.setRate(deviceRate_ * scale);
+    }
+    busBucket_.setRate(busRate_ * scale);
+}
@@ -8,10 +8,20 @@
 #include <linux/can/raw.h>
 #include <cstdlib>
 #include <sys/select.h>
+#include <chrono>
 #include "logger.h"
+#include "global_config.h"
+
+static int64_t monotonicNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
 CANInterface::CANInterface(const std::string &can_interface)
-    : can_interface_(can_interface), sock_(-1) {}
+    : can_interface_(can_interface), sock_(-1), bitrate_(CAN_BUS_BITRATE),
+      total_bits_(0), window_bits_(0), window_start_ns_(monotonicNs()), bus_load_(0.0),
+      receiving_(false) {}
 
 bool CANInterface::init()
 {    
@@ -65,11 +75,29 @@ bool CANInterface::init()
         return false;
     }
 
-    return true;
+    return startReceiver();
+}
+
+/**
+ * @brief 使用已打开的套接字并启动接收线程
+ * @details 不配置网络接口，套接字由本对象接管并在析构时关闭；
+ *          用于以 socketpair 等模拟总线运行设备（如单元测试），每次读写须为一个完整的 can_frame
+ * @param fd 已打开的套接字
+ * @return bool 启动成功返回true
+ */
+bool CANInterface::attachSocket(int fd)
+{
+    if (fd < 0 || sock_ != -1)
+    {
+        return false;
+    }
+    sock_ = fd;
+    return startReceiver();
 }
 
 CANInterface::~CANInterface()
 {
+    stopReceiver();
     if (sock_ != -1)
         close(sock_);
 }
@@ -81,6 +109,7 @@ bool CANInterface::send_frame(const struct can_frame &frame)
         LOG_ERROR("CAN 帧发送失败");
         return false;
     }
+    accountFrame(frame);
     return true;
 }
 
@@ -99,12 +128,27 @@ bool CANInterface::receive_frame(struct can_frame &frame, int timeout_ms)
         return false; // Timeout or error
     }
 
-    if (read(sock_, &frame, sizeof(frame)) < 0)
+    ssize_t n = read(sock_, &frame, sizeof(frame));
+    if (n == static_cast<ssize_t>(sizeof(frame)))
+    {
+        accountFrame(frame);
+        return true;
+    }
+    if (n < 0)
     {
         LOG_ERROR("CAN 帧接收失败: " + std::string(strerror(errno)));
-        return false;
     }
-    return true;
+    else if (n == 0)
+    {
+        // 对端关闭（如 attachSocket 接管的 socketpair）：套接字此后一直可读，停止接收线程以免空转
+        LOG_ERROR("CAN 套接字已关闭: " + can_interface_);
+        receiving_ = false;
+    }
+    else
+    {
+        LOG_ERROR("CAN 帧不完整: " + std::to_string(n) + " 字节");
+    }
+    return false;
 }
 
 bool CANInterface::is_JK_platform()
@@ -119,4 +163,194 @@ bool CANInterface::is_JK_platform()
         return model.find("RK3588S") != std::string::npos;
     }
     return false;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief 计算一帧在总线上占用的位数
+ * @details 按 CAN 2.0 帧格式逐位展开 SOF 至 CRC 段，计算 CRC15 并统计填充位，
+ *          再加上 CRC 界定符、ACK、EOF 和帧间隔共 13 个固定位
+ * @param frame CAN帧
+ * @return uint32_t 包含填充位在内的总位数
+ */
+uint32_t CANInterface::frameBitCount(const struct can_frame &frame)
+{
+    uint8_t bits[160];
+    int n = 0;
+    auto push = [&](uint32_t value, int width) {
+        for (int i = width - 1; i >= 0; i--) {
+            bits[n++] = (value >> i) & 0x01;
+        }
+    };
+
+    uint8_t dlc = frame.can_dlc > 8 ? 8 : frame.can_dlc;
+    bool rtr = frame.can_id & CAN_RTR_FLAG;
+    push(0, 1); // SOF
+    if (frame.can_id & CAN_EFF_FLAG) {
+        uint32_t id = frame.can_id & CAN_EFF_MASK;
+        push(id >> 18, 11); // 基本ID
+        push(1, 1);         // SRR
+        push(1, 1);         // IDE
+        push(id & 0x3FFFF, 18);
+        push(rtr, 1);
+        push(0, 2);         // r1 r0
+    } else {
+        push(frame.can_id & CAN_SFF_MASK, 11);
+        push(rtr, 1);
+        push(0, 2);         // IDE r0
+    }
+    push(dlc, 4);
+    if (!rtr) {
+        for (int i = 0; i < dlc; i++) {
+            push(frame.data[i], 8);
+        }
+    }
+
+    // CRC15，多项式 0x4599
+    uint16_t crc = 0;
+    for (int i = 0; i < n; i++) {
+        bool next = bits[i] ^ ((crc >> 14) & 0x01);
+        crc = (crc << 1) & 0x7FFF;
+        if (next) {
+            crc ^= 0x4599;
+        }
+    }
+    push(crc, 15);
+
+    // 连续5个相同位后插入1个填充位，填充位参与后续计数
+    uint32_t stuff = 0;
+    int run = 1;
+    uint8_t last = bits[0];
+    for (int i = 1; i < n; i++) {
+        if (bits[i] == last) {
+            run++;
+        } else {
+            last = bits[i];
+            run = 1;
+        }
+        if (run == 5) {
+            stuff++;
+            last = !last;
+            run = 1;
+        }
+    }
+
+    return n + stuff + 13;
+}
+
+/**
+ * @brief 获取当前总线利用率
+ * @details 返回最近一个完整统计窗口的利用率；若总线已静默超过一个窗口，
+ *          按当前未结束窗口的实际位数计算，避免停留在旧的高负载值
+ * @return double 总线利用率(0.0~1.0)
+ */
+double CANInterface::getBusLoad() const
+{
+    int64_t elapsed = monotonicNs() - window_start_ns_.load(std::memory_order_relaxed);
+    if (elapsed >= 2LL * CAN_BUS_LOAD_WINDOW_MS * 1000000LL) {
+        return window_bits_.load(std::memory_order_relaxed) * 1e9 / (static_cast<double>(bitrate_) * elapsed);
+    }
+    return bus_load_.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief 统计一帧的总线占用
+ * @details 发送和接收的帧都计入；窗口到期时由首个检测到的线程结算利用率并通知调节器
+ * @param frame CAN帧
+ */
+void CANInterface::accountFrame(const struct can_frame &frame)
+{
+    uint32_t bits = frameBitCount(frame);
+    total_bits_.fetch_add(bits, std::memory_order_relaxed);
+    window_bits_.fetch_add(bits, std::memory_order_relaxed);
+
+    int64_t now = monotonicNs();
+    int64_t start = window_start_ns_.load(std::memory_order_relaxed);
+    if (now - start < CAN_BUS_LOAD_WINDOW_MS * 1000000LL) {
+        return;
+    }
+    if (!window_start_ns_.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+        return; // 其他线程已结算本窗口
+    }
+
+    uint64_t windowBits = window_bits_.exchange(0, std::memory_order_relaxed);
+    double load = windowBits * 1e9 / (static_cast<double>(bitrate_) * (now - start));
+    bus_load_.store(load, std::memory_order_relaxed);
+    governor_.onBusLoad(load);
+}
+
+/**
+ * @brief 注册帧接收回调
+ * @details 接收线程收到 can_id 匹配的帧时调用 handler，回调在接收线程中执行，应尽快返回
+ * @param can_id 要接收的 CAN ID
+ * @param handler 帧处理函数，同一 CAN ID 重复注册时覆盖
+ */
+void CANInterface::addReceiver(canid_t can_id, FrameHandler handler)
+{
+    std::lock_guard<std::mutex> lock(receiversMutex_);
+    receivers_[can_id] = std::move(handler);
+}
+
+/**
+ * @brief 注销帧接收回调
+ * @details 返回后保证该回调不会再被调用
+ * @param can_id 要注销的 CAN ID
+ */
+void CANInterface::removeReceiver(canid_t can_id)
+{
+    std::lock_guard<std::mutex> lock(receiversMutex_);
+    receivers_.erase(can_id);
+}
+
+/**
+ * @brief 启动接收线程
+ * @details 由 init 在套接字就绪后调用，此后所有接收都经由接收线程分发，
+ *          设备不再直接调用 receive_frame
+ * @return bool 启动成功返回true
+ */
+bool CANInterface::startReceiver()
+{
+    if (sock_ < 0)
+    {
+        return false;
+    }
+    if (receiving_.exchange(true))
+    {
+        return true;
+    }
+    receiveThread_ = std::thread(&CANInterface::receiveLoop, this);
+    return true;
+}
+
+/**
+ * @brief 停止接收线程
+ */
+void CANInterface::stopReceiver()
+{
+    receiving_ = false;
+    if (receiveThread_.joinable())
+    {
+        receiveThread_.join();
+    }
+}
+
+/**
+ * @brief 接收线程主循环
+ * @details 每 50ms 超时一次以便检查退出标志；只分发完整读到的帧，套接字被对端关闭时退出
+ */
+void CANInterface::receiveLoop()
+{
+    struct can_frame frame;
+    while (receiving_)
+    {
+        if (!receive_frame(frame, 50))
+        {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(receiversMutex_);
+        auto it = receivers_.find(frame.can_id);
+        if (it != receivers_.end())
+        {
+            it->second(frame);
+        }
+    }
+}
@@ -0,0 +1,265 @@
+#include "rs232_interface.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include "logger.h"
+
+RS232Interface::RS232Interface(const std::string &port, speed_t baudrate)
+    : port_(port), baudrate_(baudrate), fd_(-1), epoll_fd_(-1), wake_fd_(-1),
+      want_write_(false), running_(false) {}
+
+RS232Interface::~RS232Interface()
+{
+    stop();
+    if (fd_ != -1)
+        close(fd_);
+    if (epoll_fd_ != -1)
+        close(epoll_fd_);
+    if (wake_fd_ != -1)
+        close(wake_fd_);
+}
+
+/**
+ * @brief 打开并配置串口，启动事件循环
+ * @details 8N1 原始模式，无流控；VMIN/VTIME 均为0，读写全部非阻塞
+ * @return bool 成功返回true
+ */
+bool RS232Interface::init()
+{
+    fd_ = open(port_.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd_ < 0)
+    {
+        LOG_ERROR("串口打开失败: " + port_ + " (" + std::string(strerror(errno)) + ")");
+        return false;
+    }
+
+    struct termios tty;
+    if (tcgetattr(fd_, &tty) != 0)
+    {
+        LOG_ERROR("串口参数读取失败: " + port_ + " (" + std::string(strerror(errno)) + ")");
+        return false;
+    }
+    cfmakeraw(&tty);
+    cfsetospeed(&tty, baudrate_);
+    cfsetispeed(&tty, baudrate_);
+    tty.c_cflag |= (CLOCAL | CREAD);
+    tty.c_cflag &= ~(PARENB | PARODD | CSTOPB | CRTSCTS);
+    tty.c_iflag &= ~(IXON | IXOFF | IXANY);
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
+    if (tcsetattr(fd_, TCSANOW, &tty) != 0)
+    {
+        LOG_ERROR("串口参数设置失败: " + port_ + " (" + std::string(strerror(errno)) + ")");
+        return false;
+    }
+    tcflush(fd_, TCIOFLUSH);
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd_ < 0 || wake_fd_ < 0)
+    {
+        LOG_ERROR("串口事件循环创建失败: " + std::string(strerror(errno)));
+        return false;
+    }
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd_, &ev);
+    ev.events = EPOLLIN;
+    ev.data.fd = wake_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+
+    running_ = true;
+    loop_thread_ = std::thread(&RS232Interface::eventLoop, this);
+    LOG_INFO("串口已打开: " + port_);
+    return true;
+}
+
+bool RS232Interface::send_frame(const struct can_frame &frame)
+{
+    (void)frame;
+    return false;
+}
+
+bool RS232Interface::receive_frame(struct can_frame &frame, int timeout_ms)
+{
+    (void)frame;
+    (void)timeout_ms;
+    return false;
+}
+
+/**
+ * @brief 发送数据
+ * @details 不阻塞：能立即写出的部分直接写出，其余部分由事件循环在串口可写时发送
+ * @param data 数据
+ * @param length 字节数
+ * @return bool 数据已写出或已进入发送缓存返回true
+ */
+bool RS232Interface::write(const uint8_t *data, size_t length)
+{
+    if (fd_ < 0)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(tx_mutex_);
+    size_t offset = 0;
+    if (tx_pending_.empty())
+    {
+        while (offset < length)
+        {
+            ssize_t n = ::write(fd_, data + offset, length - offset);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    break;
+                LOG_ERROR("串口发送失败: " + port_ + " (" + std::string(strerror(errno)) + ")");
+                return false;
+            }
+            offset += static_cast<size_t>(n);
+        }
+    }
+    if (offset < length)
+    {
+        tx_pending_.insert(tx_pending_.end(), data + offset, data + length);
+        updateEvents();
+    }
+    return true;
+}
+
+/**
+ * @brief 设置接收回调
+ * @details 回调在事件循环线程中执行，每次收到的数据块长度任意，可能包含半帧或多帧
+ * @param handler 接收回调
+ */
+void RS232Interface::setReceiver(DataHandler handler)
+{
+    std::lock_guard<std::mutex> lock(receiver_mutex_);
+    receiver_ = std::move(handler);
+}
+
+/**
+ * @brief 写出发送缓存中的数据
+ * @note 调用者需持有 tx_mutex_
+ */
+void RS232Interface::flushPending()
+{
+    size_t offset = 0;
+    while (offset < tx_pending_.size())
+    {
+        ssize_t n = ::write(fd_, tx_pending_.data() + offset, tx_pending_.size() - offset);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                LOG_ERROR("串口发送失败: " + port_ + " (" + std::string(strerror(errno)) + ")");
+                offset = tx_pending_.size();
+            }
+            break;
+        }
+        offset += static_cast<size_t>(n);
+    }
+    tx_pending_.erase(tx_pending_.begin(), tx_pending_.begin() + offset);
+    updateEvents();
+}
+
+/**
+ * @brief 按发送缓存是否为空注册/取消 EPOLLOUT
+ * @note 调用者需持有 tx_mutex_
+ */
+void RS232Interface::updateEvents()
+{
+    bool want = !tx_pending_.empty();
+    if (want == want_write_)
+    {
+        return;
+    }
+    struct epoll_event ev;
+    ev.events = static_cast<uint32_t>(EPOLLIN) | (want ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    ev.data.fd = fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd_, &ev);
+    want_write_ = want;
+}
+
+/**
+ * @brief 事件循环
+ * @details 串口可读时一次读取尽可能多的数据交给接收回调；可写时继续发送缓存数据。
+ *          串口挂断或读取出错时从 epoll 中摘除并退出循环
+ */
+void RS232Interface::eventLoop()
+{
+    uint8_t buffer[4096];
+    struct epoll_event events[2];
+    while (running_)
+    {
+        int count = epoll_wait(epoll_fd_, events, 2, -1);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            LOG_ERROR("串口事件循环错误: " + std::string(strerror(errno)));
+            break;
+        }
+        for (int i = 0; i < count; i++)
+        {
+            if (events[i].data.fd == wake_fd_)
+            {
+                uint64_t value;
+                ssize_t ignored = read(wake_fd_, &value, sizeof(value));
+                (void)ignored;
+                continue;
+            }
+            if (events[i].events & EPOLLOUT)
+            {
+                std::lock_guard<std::mutex> lock(tx_mutex_);
+                flushPending();
+            }
+            if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+            {
+                ssize_t n;
+                while ((n = read(fd_, buffer, sizeof(buffer))) > 0)
+                {
+                    std::lock_guard<std::mutex> lock(receiver_mutex_);
+                    if (receiver_)
+                    {
+                        receiver_(buffer, static_cast<size_t>(n));
+                    }
+                }
+                // 拔出后 read 通常返回 -1(EIO) 而非 0；水平触发下不摘除会一直被唤醒
+                int error = n < 0 ? errno : 0;
+                bool hangup = (events[i].events & (EPOLLERR | EPOLLHUP)) != 0;
+                if ((hangup && n <= 0) || (n < 0 && error != EAGAIN && error != EWOULDBLOCK && error != EINTR))
+                {
+                    LOG_ERROR("串口已断开: " + port_ + (error != 0 ? " (" + std::string(strerror(error)) + ")" : ""));
+                    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd_, nullptr);
+                    running_ = false;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief 停止事件循环
+ */
+void RS232Interface::stop()
+{
+    running_ = false;
+    if (wake_fd_ != -1)
+    {
+        uint64_t value = 1;
+        ssize_t ignored = ::write(wake_fd_, &value, sizeof(value));
+        (void)ignored;
+    }
+    if (loop_thread_.joinable())
+    {
+        loop_thread_.join();
+    }
+}
@@ -0,0 +1,105 @@
+/**
+ * @file alloc_counter.cpp
+ * @brief 堆分配计数实现文件
+ * @details 替换全部普通、数组、nothrow 与对齐形式的 operator new/delete；
+ *          其余带 size 的 delete 形式由标准库转发到这里的未带 size 版本
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "alloc_counter.h"
+#include "global_config.h"
+#include <atomic>
+
+namespace {
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_deallocations{0};
+std::atomic<uint64_t> g_bytes{0};
+} // namespace
+
+bool AllocCounter::enabled()
+{
+    return ALLOC_COUNTER_ENABLED != 0;
+}
+
+AllocCounter::Snapshot AllocCounter::snapshot()
+{
+    return {g_allocations.load(std::memory_order_relaxed),
+            g_deallocations.load(std::memory_order_relaxed),
+            g_bytes.load(std::memory_order_relaxed)};
+}
+
+#if ALLOC_COUNTER_ENABLED
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+void *countedAlloc(std::size_t size, std::size_t alignment)
+{
+    if (size == 0)
+    {
+        size = 1;
+    }
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+    for (;;)
+    {
+        void *ptr = nullptr;
+        if (alignment <= alignof(std::max_align_t))
+        {
+            ptr = std::malloc(size);
+        }
+        else if (posix_memalign(&ptr, alignment, size) != 0)
+        {
+            ptr = nullptr;
+        }
+        if (ptr)
+        {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+        {
+            return nullptr;
+        }
+        handler();
+    }
+}
+
+void countedFree(void *ptr)
+{
+    if (ptr)
+    {
+        g_deallocations.fetch_add(1, std::memory_order_relaxed);
+        std::free(ptr);
+    }
+}
+
+void *throwingAlloc(std::size_t size, std::size_t alignment)
+{
+    void *ptr = countedAlloc(size, alignment);
+    if (!ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+} // namespace
+
+void *operator new(std::size_t size) { return throwingAlloc(size, 0); }
+void *operator new[](std::size_t size) { return throwingAlloc(size, 0); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return countedAlloc(size, 0); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return countedAlloc(size, 0); }
+void *operator new(std::size_t size, std::align_val_t al) { return throwingAlloc(size, static_cast<std::size_t>(al)); }
+void *operator new[](std::size_t size, std::align_val_t al) { return throwingAlloc(size, static_cast<std::size_t>(al)); }
+
+void operator delete(void *ptr) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept { countedFree(ptr); }
+#endif
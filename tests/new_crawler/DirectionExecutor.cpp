@@ -0,0 +1,216 @@
+#include "DirectionExecutor.h"
+#include <cmath>
+#include <iostream>
+
+DirectionExecutor::DirectionExecutor(MotorController &motor, LH08Controller &relay, std::function<bool(int)> relayFor)
+    : motor(motor), relay(relay), relayFor(std::move(relayFor)) {}
+
+DirectionExecutor::~DirectionExecutor()
+{
+    stop();
+}
+
+void DirectionExecutor::start(void)
+{
+    if (running.exchange(true))
+    {
+        return;
+    }
+    worker = std::thread(&DirectionExecutor::loop, this);
+}
+
+void DirectionExecutor::stop(void)
+{
+    running = false;
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+// 固定周期执行，按绝对时间推进，避免处理耗时累积成周期漂移
+void DirectionExecutor::loop(void)
+{
+    const auto period = std::chrono::milliseconds(DIRECTION_TICK_MS);
+    const double dv = DIRECTION_ACCEL_DPS2 * DIRECTION_TICK_MS / 1000.0;
+    auto next = std::chrono::steady_clock::now();
+    while (running)
+    {
+        syncDirection();
+        if (manual)
+        {
+            runManual();
+        }
+        else
+        {
+            tick(dv);
+
+            int32_t command = static_cast<int32_t>(std::lround(current));
+            if (command != sent)
+            {
+                motor.set_speed(units::Dps(command));
+                sent = command;
+            }
+        }
+
+        next += period;
+        auto now = std::chrono::steady_clock::now();
+        if (next < now)
+        {
+            next = now;  // 等待继电器等阻塞操作后重新对齐
+        }
+        std::this_thread::sleep_until(next);
+    }
+}
+
+// 从继电器控制器的已确认状态推出当前方向；换向命令在途时以执行器自己的记录为准
+void DirectionExecutor::syncDirection(void)
+{
+    if (pendingDirection != 0)
+    {
+        return;
+    }
+    int state = relay.getAppliedStatus(1);
+    if (state < 0)
+    {
+        direction = 0;
+        return;
+    }
+    direction = (state != 0) == relayFor(1) ? 1 : -1;
+}
+
+// 手动状态：下发手动速度，放弃进行中的换向；电机可能被其它途径操作，已下发速度视为未知
+void DirectionExecutor::runManual(void)
+{
+    phase = Phase::CRUISE;
+    pendingDirection = 0;
+    relaySwitched = false;
+    int64_t speed = manualSpeed.exchange(MANUAL_NONE);
+    if (speed != MANUAL_NONE)
+    {
+        current = static_cast<double>(speed);
+        motor.set_speed(units::Dps(static_cast<int32_t>(speed)));
+    }
+    sent = SENT_UNKNOWN;
+}
+
+// 单步状态机
+void DirectionExecutor::tick(double dv)
+{
+    int32_t goal = target;
+    int want = sign(goal);
+
+    switch (phase)
+    {
+    case Phase::CRUISE:
+        if (want != 0 && want != direction && sign(static_cast<int32_t>(std::lround(current))) != 0)
+        {
+            // 方向相反或未知且仍在运动：先减速到零再切继电器
+            phase = Phase::DECEL;
+            relaySwitched = false;
+            reversalStart = std::chrono::steady_clock::now();
+            tick(dv);
+            return;
+        }
+        if (want != 0 && want != direction)
+        {
+            // 静止或方向未知：先切继电器再下发速度
+            if (!switchAtZero(want))
+            {
+                current = 0;
+                return;
+            }
+        }
+        current = goal;
+        return;
+
+    case Phase::DECEL:
+    {
+        if (pendingDirection == 0 && want == direction)
+        {
+            // 换向被撤销，继电器尚未动作，直接加速回目标
+            phase = Phase::ACCEL;
+            return;
+        }
+        current = current > 0 ? std::max(0.0, current - dv) : std::min(0.0, current + dv);
+
+        // 剩余减速时间不超过继电器往返时间时发出换向命令，使继电器确认与减速重叠
+        int64_t timeToZeroUs = static_cast<int64_t>(std::fabs(current) / DIRECTION_ACCEL_DPS2 * 1e6);
+        int64_t leadUs = relay.getRoundTripUs() + relay.getCoalesceWindow() * 1000 + DIRECTION_RELAY_MARGIN_US;
+        if (want != 0 && pendingDirection == 0 && timeToZeroUs <= leadUs)
+        {
+            requestRelay(want);
+        }
+
+        if (current == 0)
+        {
+            if (pendingDirection == 0 && want == 0)
+            {
+                phase = Phase::CRUISE;  // 换向途中改为停车
+                return;
+            }
+            int dir = pendingDirection != 0 ? pendingDirection : want;
+            if (!switchAtZero(dir))
+            {
+                phase = Phase::CRUISE;
+                return;
+            }
+            relaySwitched = true;
+            phase = Phase::ACCEL;
+        }
+        return;
+    }
+
+    case Phase::ACCEL:
+        if (want != 0 && want != direction)
+        {
+            phase = Phase::DECEL;  // 加速途中再次换向
+            tick(dv);
+            return;
+        }
+        if (std::fabs(goal - current) <= dv)
+        {
+            current = goal;
+            phase = Phase::CRUISE;
+            if (relaySwitched)
+            {
+                // 被撤销的换向没有切换继电器，不计入统计
+                reversalCount++;
+                lastReversalMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - reversalStart).count();
+                relaySwitched = false;
+            }
+            return;
+        }
+        current += goal > current ? dv : -dv;
+        return;
+    }
+}
+
+// 零速时完成换向：发出（如尚未发出）并等待继电器确认
+bool DirectionExecutor::switchAtZero(int dir)
+{
+    if (pendingDirection != dir)
+    {
+        requestRelay(dir);
+    }
+    auto start = std::chrono::steady_clock::now();
+    bool ok = relay.flush() && relay.waitApplied();
+    lastRelayWaitMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    pendingDirection = 0;
+    if (!ok)
+    {
+        std::cout << "错误: 继电器换向未确认，保持零速。" << std::endl;
+        direction = 0;
+        return false;
+    }
+    direction = dir;
+    return true;
+}
+
+// 发出换向命令，由继电器控制器的合并线程异步发送
+void DirectionExecutor::requestRelay(int dir)
+{
+    relay.setStatus(1, relayFor(dir) ? 0x02 : 0x01);
+    pendingDirection = dir;
+}
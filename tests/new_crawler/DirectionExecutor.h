@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <thread>
+#include "MotorController.h"
+#include "LH08Controller.h"
+
+#define DIRECTION_TICK_MS 5             // 速度下发周期
+#define DIRECTION_ACCEL_DPS2 1000       // 换向时的减速/加速度(dps/s)
+#define DIRECTION_RELAY_MARGIN_US 2000  // 继电器确认相对零速时刻的提前量
+
+// 换向执行器
+// 速度符号不变时直接下发目标速度；符号改变时：
+//   1. 以 DIRECTION_ACCEL_DPS2 减速到0
+//   2. 按继电器往返时间估计提前发出换向命令，使继电器确认与减速重叠
+//   3. 零速且继电器已确认后，以同样加速度加速到新的目标速度
+// 所有速度命令都由执行器线程发出，move() 只更新目标，不阻塞
+// 继电器方向每周期从 LH08Controller 的已确认状态重新读取，其它途径切换继电器后执行器随之更新；
+// 手动命令(setSpeed/hold)使执行器暂停跟随目标，直到下一次 move()
+class DirectionExecutor {
+public:
+    // relayFor(dir) 返回方向 dir(+1/-1) 对应的继电器状态(true=开)
+    DirectionExecutor(MotorController &motor, LH08Controller &relay, std::function<bool(int)> relayFor);
+    ~DirectionExecutor();
+
+    void start(void);
+    void stop(void);
+
+    // 设置目标速度(dps)，退出手动状态
+    void move(int32_t speed) { target = speed; manual = false; }
+
+    // 手动下发速度(dps)：不经换向逻辑，由执行器线程发出
+    void setSpeed(int32_t speed) { manualSpeed = speed; manual = true; }
+
+    // 其它途径将直接操作电机或继电器：暂停跟随目标，下一次 move() 的速度总会重新下发
+    void hold(void) { manualSpeed = MANUAL_NONE; manual = true; }
+
+    // 统计：完成的换向次数 / 最近一次换向耗时(毫秒) / 最近一次在零速等待继电器的时间(毫秒)
+    uint64_t getReversalCount(void) const { return reversalCount; }
+    int64_t getLastReversalMs(void) const { return lastReversalMs; }
+    int64_t getLastRelayWaitMs(void) const { return lastRelayWaitMs; }
+
+private:
+    enum class Phase {
+        CRUISE,  // 直接跟随目标
+        DECEL,   // 换向减速
+        ACCEL    // 换向后加速
+    };
+
+    static constexpr int64_t MANUAL_NONE = std::numeric_limits<int64_t>::min();
+    static constexpr int32_t SENT_UNKNOWN = std::numeric_limits<int32_t>::min();
+
+    void loop(void);
+    void tick(double dv);
+    void runManual(void);
+    void syncDirection(void);
+    bool switchAtZero(int dir);
+    void requestRelay(int dir);
+    static int sign(int32_t v) { return (v > 0) - (v < 0); }
+
+    MotorController &motor;
+    LH08Controller &relay;
+    std::function<bool(int)> relayFor;
+
+    std::atomic<int32_t> target{0};
+    std::atomic<bool> manual{false};
+    std::atomic<int64_t> manualSpeed{MANUAL_NONE};  // 待下发的手动速度
+    std::atomic<bool> running{false};
+    std::thread worker;
+
+    // 以下仅执行器线程访问
+    Phase phase = Phase::CRUISE;
+    double current = 0;        // 当前下发的速度(dps)
+    int32_t sent = 0;          // 最近一次下发的速度，SENT_UNKNOWN 表示电机状态未知
+    int direction = 0;         // 继电器当前对应的方向，0 表示未知
+    int pendingDirection = 0;  // 已发出但尚未确认的换向方向
+    bool relaySwitched = false;  // 本次换向是否已切换继电器
+    std::chrono::steady_clock::time_point reversalStart;
+
+    std::atomic<uint64_t> reversalCount{0};
+    std::atomic<int64_t> lastReversalMs{0};
+    std::atomic<int64_t> lastRelayWaitMs{0};
+};
@@ -0,0 +1,187 @@
+// 换向执行器测试
+// 电机由本文件中的 MotorController 替身记录下发的速度；继电器板由 socketpair 另一端的线程模拟，
+// 每帧延迟 BOARD_DELAY_MS 后执行并应答。检查：
+//   - 换向时新方向的速度只在继电器切换之后下发，继电器确认与减速重叠
+//   - 被撤销的换向不计入换向次数
+//   - 手动切换继电器、手动下发速度之后，move 的速度和方向会重新下发
+#include "DirectionExecutor.h"
+#include <sys/socket.h>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#define BOARD_DELAY_MS 20
+
+static int failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::printf("%s:%d: 检查失败: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+// 模拟继电器板：收到一帧后延迟 BOARD_DELAY_MS 执行并回显实际状态
+class FakeBoard {
+public:
+    explicit FakeBoard(int fd) : fd(fd), thread(&FakeBoard::run, this) {}
+
+    ~FakeBoard() {
+        shutdown(fd, SHUT_RDWR);
+        thread.join();
+        close(fd);
+    }
+
+    uint8_t getMask(void) const { return mask; }
+
+private:
+    void run(void) {
+        LH08Parser parser;
+        uint8_t buffer[64];
+        ssize_t n;
+        while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+            parser.feed(buffer, static_cast<size_t>(n), [this](const uint8_t* frame) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(BOARD_DELAY_MS));
+                if (frame[3] == LH08_SET) {
+                    mask = lh08DecodeRelayMask(frame);
+                }
+                uint8_t relays[LH08_RELAY_COUNT];
+                uint8_t reply[LH08_FRAME_SIZE];
+                lh08RelayStates(mask, relays);
+                lh08EncodeFrame(frame[3], relays, reply);
+                if (write(fd, reply, sizeof(reply)) != static_cast<ssize_t>(sizeof(reply))) {
+                    std::printf("继电器板应答写入失败\n");
+                }
+            });
+        }
+    }
+
+    int fd;
+    std::atomic<uint8_t> mask{0};
+    std::thread thread;
+};
+
+static FakeBoard* board = nullptr;
+
+// 电机替身：记录速度，并检查继电器方向（开=正向）与速度符号不一致时只会出现在减速段：
+// 继电器命令按往返时间提前发出，板子可能在减速的最后几个周期内动作
+static std::mutex motorMutex;
+static std::vector<int32_t> speeds;
+static std::atomic<bool> checking{true};
+static std::atomic<int> violations{0};
+
+MotorController::MotorController(CANInterface &can_interface, int motor_id)
+    : can_interface_(can_interface), motor_id_(motor_id) {}
+
+bool MotorController::enable_motor() { return true; }
+bool MotorController::disable_motor() { return true; }
+bool MotorController::stop_motor() { return true; }
+
+bool MotorController::set_speed(units::CentiDps target_speed)
+{
+    int32_t speed = target_speed.raw() / 100;
+    std::lock_guard<std::mutex> lock(motorMutex);
+    int32_t previous = speeds.empty() ? 0 : speeds.back();
+    bool decelerating = (speed > 0 && previous > speed) || (speed < 0 && previous < speed);
+    if (checking && speed != 0 && !decelerating && (speed > 0) != ((board->getMask() & 1) != 0)) {
+        violations++;
+    }
+    speeds.push_back(speed);
+    return true;
+}
+
+static int32_t lastSpeed(void)
+{
+    std::lock_guard<std::mutex> lock(motorMutex);
+    return speeds.empty() ? 0 : speeds.back();
+}
+
+static size_t speedCount(void)
+{
+    std::lock_guard<std::mutex> lock(motorMutex);
+    return speeds.size();
+}
+
+template <typename Pred>
+static bool waitFor(Pred pred, int timeout_ms)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+int main()
+{
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        std::printf("socketpair 失败\n");
+        return 1;
+    }
+    board = new FakeBoard(fds[1]);
+
+    LH08Controller lh08;
+    lh08.openRS232Port(fds[0]);
+    CANInterface can("vcan0");
+    MotorController motor(can, 1);
+    DirectionExecutor executor(motor, lh08, [](int dir) { return dir > 0; });
+    executor.start();
+
+    // 静止起步：先切继电器再下发速度
+    executor.move(100);
+    CHECK(waitFor([] { return lastSpeed() == 100; }, 1000));
+    CHECK(board->getMask() == 1);
+
+    // 换向：继电器确认与减速重叠，零速时等待时间短于一次往返
+    executor.move(-100);
+    CHECK(waitFor([&] { return executor.getReversalCount() == 1 && lastSpeed() == -100; }, 2000));
+    CHECK(board->getMask() == 0);
+    CHECK(executor.getLastRelayWaitMs() < BOARD_DELAY_MS);
+    CHECK(violations == 0);
+
+    // 换向在发出继电器命令前被撤销：不切继电器，不计入换向次数
+    uint64_t writes = lh08.getWriteCount();
+    executor.move(100);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    executor.move(-100);
+    CHECK(waitFor([] { return lastSpeed() == -100; }, 1000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    CHECK(executor.getReversalCount() == 1);
+    CHECK(lh08.getWriteCount() == writes);
+    CHECK(violations == 0);
+
+    // 绕过执行器切换继电器后，原方向的 move 重新切回继电器
+    checking = false;
+    executor.hold();
+    CHECK(lh08.setStatus(1, LH08_RELAY_ON));
+    CHECK(lh08.flush());
+    CHECK(board->getMask() == 1);
+    executor.move(-200);
+    CHECK(waitFor([] { return lastSpeed() == -200 && board->getMask() == 0; }, 2000));
+    CHECK(executor.getReversalCount() == 2);
+
+    // 手动下发速度后，相同目标的 move 重新下发
+    executor.setSpeed(50);
+    CHECK(waitFor([] { return lastSpeed() == 50; }, 1000));
+    size_t count = speedCount();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(speedCount() == count);  // 手动状态下执行器不再跟随目标
+    executor.move(-200);
+    CHECK(waitFor([] { return lastSpeed() == -200; }, 2000));
+
+    executor.stop();
+    lh08.closeRS232Port();
+    delete board;
+
+    if (failures) {
+        std::printf("%d 项检查失败\n", failures);
+        return 1;
+    }
+    std::printf("全部通过\n");
+    return 0;
+}
@@ -1,56 +1,221 @@
 #include "LH08Controller.h"
 #include "RS232Interface.h"
+#include <poll.h>
 
-// 计算校验和
-uint8_t LH08Controller::RS0x24_sum8(std::vector<uint8_t> &data, size_t length) {
-    uint8_t sum = 0;
-    for(int i = 0; i < length; i++) {
-        sum += data[i];
-    }
-    return sum;
+// 使用已有的文件描述符，读取继电器当前状态作为缓存初值并启动合并线程
+void LH08Controller::openRS232Port(int fd) {
+    closeRS232Port();
+    this->fd = fd;
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);  // 应答由 poll 等待，读取不阻塞
+    std::cout << "串口已打开: " << this->fd << std::endl;
+    getStatus();
+    running = true;
+    worker = std::thread(&LH08Controller::workerLoop, this);
 }
 
-// 生成消息并发送
-void LH08Controller::createMsg(void) {
-    if(message[3] != 0x00) {   // 如果是设置状态
-        for(int i = 0; i < 8; i++) {
-            message[i+4] = status[i];  // 设置继电器状态
+// 关闭串口：先提交尚未发送的修改
+void LH08Controller::closeRS232Port(void) {
+    if(running) {
+        flush();
+        running = false;
+        stateCv.notify_all();
+        if(worker.joinable()) {
+            worker.join();
         }
     }
-    message[12] = RS0x24_sum8(message, 12);  // 计算并添加校验和
-    write(fd, message.data(), message.size());  // 发送消息
-    ssize_t ret = read(fd, recvMsg.data(), recvMsg.size());  // 读取响应
-    if(ret < 0) {
-        std::cout << "错误: 读取的字节数小于0。" << std::endl;
-        return;
+    if(fd >= 0) {
+        close(fd);
+        fd = -1;
     }
-    uint8_t check_byte = RS0x24_sum8(recvMsg, 12);  // 校验响应的校验和
-    if(check_byte != recvMsg[12]) {
-        std::cout << "校验失败!" << std::endl;
+}
+
+// 设置单个继电器：只修改期望状态，由后台线程在合并窗口结束时发送
+bool LH08Controller::setStatus(uint8_t pos, uint8_t status) {
+    if(pos < 1 || pos > 8) {
+        std::cout << "无效的位置，位置范围: 1~8。" << std::endl;
+        return false;
     }
+    std::lock_guard<std::mutex> lock(stateMutex);
+    uint8_t bit = 1u << (pos - 1);
+    uint8_t mask = (status == LH08_RELAY_ON) ? (desiredMask | bit) : (desiredMask & ~bit);
+    bool changed = mask != desiredMask || !appliedKnown;
+    setDesired(mask);
+    return changed;
+}
+
+// 获取所有继电器的状态
+void LH08Controller::getStatus(void) {
+    std::lock_guard<std::mutex> io(ioMutex);
+    message[3] = 0x00;  // 查询状态
+    createMsg();  // 生成消息并发送
 }
 
-// 设置8个继电器的状态
+// 读取已确认的状态，不访问串口
+int LH08Controller::getAppliedStatus(uint8_t pos) {
+    if(pos < 1 || pos > 8) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(stateMutex);
+    if(!appliedKnown || pending || desiredMask != appliedMask) {
+        return -1;
+    }
+    return (appliedMask >> (pos - 1)) & 1;
+}
+
+// 设置8个继电器的状态，与当前状态相同时不发送
 void LH08Controller::setStatus08(std::string str) {
     short pos = std::stoi(str, nullptr, 16);    // 将十六进制字符串转换为整数
-    for(int i = 0; i < 8; i++) {
-        if(pos & (0x01 << i)) {  // 如果位为1，则开启继电器
-            message[3+i+1] = 0x02;
-        } else {
-            message[3+i+1] = 0x01;  // 如果位为0，则关闭继电器
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        setDesired(static_cast<uint8_t>(pos & 0xFF));
+    }
+    flush();
+}
+
+// 立即提交尚未发送的修改
+bool LH08Controller::flush(void) {
+    return commit();
+}
+
+// 等待期望状态被确认
+bool LH08Controller::waitApplied(int timeout_ms) {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    return stateCv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]() {
+        return appliedKnown && !pending && appliedMask == desiredMask;
+    });
+}
+
+// 更新期望状态（调用者需持有 stateMutex）
+void LH08Controller::setDesired(uint8_t mask) {
+    desiredMask = mask;
+    if(appliedKnown && desiredMask == appliedMask) {
+        // 无变化或窗口内被改回，无需访问串口
+        if(!pending) {
+            suppressedCount++;
+        }
+        pending = false;
+        return;
+    }
+    if(!pending) {
+        pending = true;
+        pendingSince = std::chrono::steady_clock::now();
+        stateCv.notify_all();
+    }
+}
+
+// 发送期望状态：在串口锁内读取最新期望值，保证多个提交者按顺序发送时最后一帧总是最新状态
+// 未收到应答时恢复待发送标记，由合并线程重试
+bool LH08Controller::commit(void) {
+    std::lock_guard<std::mutex> io(ioMutex);
+    uint8_t mask;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if(!pending) {
+            return true;
         }
+        mask = desiredMask;
+        pending = false;
     }
+    lh08RelayStates(mask, status.data());
     message[3] = 0x01;
-    message[12] = RS0x24_sum8(message, 12);  // 计算校验和
+    if(createMsg()) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(stateMutex);
+    if(!pending && !(appliedKnown && desiredMask == appliedMask)) {
+        pending = true;
+        pendingSince = std::chrono::steady_clock::now();
+        stateCv.notify_all();
+    }
+    return false;
+}
+
+// 合并线程：第一次修改后等待合并窗口结束，再把窗口内的全部修改作为一帧发送
+void LH08Controller::workerLoop(void) {
+    while(running) {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        stateCv.wait(lock, [this]() { return pending || !running; });
+        if(!running) {
+            break;
+        }
+        auto deadline = pendingSince + std::chrono::milliseconds(coalesceMs.load());
+        stateCv.wait_until(lock, deadline, [this]() { return !pending || !running; });
+        lock.unlock();
+        commit();
+    }
+}
+
+// 生成消息并发送，返回是否收到应答（调用者需持有 ioMutex）
+bool LH08Controller::createMsg(void) {
+    if(message[3] != 0x00) {   // 如果是设置状态
+        for(int i = 0; i < 8; i++) {
+            message[i+4] = status[i];  // 设置继电器状态
+        }
+    }
+    message[12] = lh08Sum8(message.data(), 12);  // 计算并添加校验和
+    auto start = std::chrono::steady_clock::now();
     write(fd, message.data(), message.size());  // 发送消息
-    usleep(30000);  // 延时30ms
-    ssize_t ret = read(fd, recvMsg.data(), recvMsg.size());  // 读取响应
-    if(ret < 0) {
-        std::cout << "错误: 读取的字节数小于0。" << std::endl;
-        return;
+    if(message[3] != 0x00) {
+        writeCount++;
+    }
+    if(!waitResponse(message[3])) {
+        return false;
     }
-    uint8_t check_byte = RS0x24_sum8(recvMsg, 12);  // 校验响应的校验和
-    if(check_byte != recvMsg[12]) {
+    // 以应答中的实际状态更新缓存
+    int64_t rtt = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    roundTripUs = (roundTripUs * 7 + rtt) / 8;
+    std::lock_guard<std::mutex> lock(stateMutex);
+    appliedMask = lh08DecodeRelayMask(recvMsg);
+    if(!appliedKnown) {
+        desiredMask = appliedMask;
+    }
+    appliedKnown = true;
+    pending = pending && desiredMask != appliedMask;
+    stateCv.notify_all();
+    return true;
+}
+
+// 等待指定功能码的应答：poll 等待可读，每次读取尽可能多的数据交给分帧器
+bool LH08Controller::waitResponse(uint8_t function, int timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    uint64_t errors = parser.getChecksumErrors();
+    bool received = false;
+    uint8_t buffer[256];
+
+    while(!received) {
+        int remain = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count());
+        if(remain < 0) {
+            break;
+        }
+        struct pollfd pfd = {fd, POLLIN, 0};
+        int ret = poll(&pfd, 1, remain);
+        if(ret < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            std::cout << "错误: 等待串口数据失败。" << std::endl;
+            return false;
+        }
+        if(ret == 0) {
+            break;
+        }
+        ssize_t n;
+        while((n = read(fd, buffer, sizeof(buffer))) > 0) {
+            parser.feed(buffer, static_cast<size_t>(n), [&](const uint8_t* frame) {
+                if(frame[3] == function) {
+                    std::copy(frame, frame + LH08_FRAME_SIZE, recvMsg);
+                    received = true;
+                }
+            });
+        }
+    }
+
+    if(parser.getChecksumErrors() != errors) {
         std::cout << "校验失败!" << std::endl;
     }
+    if(!received) {
+        std::cout << "错误: 等待继电器应答超时。" << std::endl;
+    }
+    return received;
 }
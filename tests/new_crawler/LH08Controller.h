@@ -4,15 +4,25 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <termios.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <iostream>
 #include <string>
 #include "RS232Interface.h"
+#include "lh08_protocol.h"
 
 #define BAUDRATE B57600  // 设置波特率
 #define RS232_PORT "/dev/ttyS6"  // 串口路径
+#define LH08_TIMEOUT_MS 200      // 应答超时
+#define LH08_COALESCE_MS 5       // 合并窗口：窗口内的多次继电器修改合并为一帧发送
 
 // 8路继电器控制类
+// 维护继电器状态缓存：与已确认状态相同的修改不访问串口；
+// 窗口内的多次修改由后台线程合并为一帧，也可调用 flush() 立即提交
 class LH08Controller {
 public:
     LH08Controller(): message(13), fd(-1) {
@@ -21,11 +31,16 @@ public:
         message[2] = 0x0A;
     }
 
+    ~LH08Controller() {
+        closeRS232Port();
+    }
+
     // 打开串口
     bool openRS232Port(const char* port = RS232_PORT) {
-        fd = setup_serial_port(port, BAUDRATE);
+        int fd = setup_serial_port(port, BAUDRATE);
         if(fd >= 0) {
-            std::cout << "串口已打开: " << fd << " (设备: " << port << ")" << std::endl;
+            openRS232Port(fd);
+            std::cout << "设备: " << port << std::endl;
             return true;
         } else {
             std::cout << "串口打开失败: " << port << std::endl;
@@ -34,46 +49,68 @@ public:
     }
 
     // 使用已有的文件描述符
-    void openRS232Port(int fd) {
-        this->fd = fd;
-        std::cout << "串口已打开: " << this->fd << std::endl;
-    }
+    void openRS232Port(int fd);
 
     // 关闭串口
-    void closeRS232Port(void) {
-        if(fd >= 0) {
-            close(fd);
-            fd = -1;
-        }
-    }
+    void closeRS232Port(void);
 
     // 设置某个继电器的状态，1~8表示继电器的位置，status表示继电器状态（0x01为关闭，0x02为开启）
-    void setStatus(uint8_t pos, uint8_t status) {    
-        if(pos < 1 || pos > 8) {
-            std::cout << "无效的位置，位置范围: 1~8。" << std::endl;
-            return;
-        }
-        this->status[pos-1] = status;
-        message[3] = 0x01;
-        createMsg();  // 生成消息并发送
-    }
+    // 返回 true 表示状态有变化、已安排写入；与当前状态相同时不访问串口
+    bool setStatus(uint8_t pos, uint8_t status);
 
-    // 获取所有继电器的状态
-    void getStatus(void) {
-        message[3] = 0x00;  // 查询状态
-        createMsg();  // 生成消息并发送
-    }
+    // 获取所有继电器的状态，同时刷新状态缓存
+    void getStatus(void);
+
+    // 读取缓存中某个继电器已确认的状态：1 为开启，0 为关闭；尚未确认或有未完成的修改时返回 -1
+    int getAppliedStatus(uint8_t pos);
 
     // 通过传入的字符串设置8个继电器的状态
     void setStatus08(std::string str);
 
+    // 立即提交尚未发送的修改并等待应答；未收到应答返回 false，修改保留由后台线程重试
+    bool flush(void);
+
+    // 等待期望状态被继电器板确认，超时返回 false
+    bool waitApplied(int timeout_ms = LH08_TIMEOUT_MS);
+
+    // 设置合并窗口(毫秒)，0 表示每次修改立即由后台线程发送
+    void setCoalesceWindow(int ms) { coalesceMs = ms; }
+    int getCoalesceWindow(void) const { return coalesceMs; }
+
+    // 设置帧的往返时间估计(微秒)，从写出到收到应答的滑动平均
+    int64_t getRoundTripUs(void) const { return roundTripUs; }
+
+    // 统计：实际写帧数 / 被抑制的无变化修改数
+    uint64_t getWriteCount(void) const { return writeCount; }
+    uint64_t getSuppressedCount(void) const { return suppressedCount; }
+
 private:
-    uint8_t RS0x24_sum8(std::vector<uint8_t> &data, size_t length);  // 校验和函数
-    void createMsg(void);   // 组装消息
+    bool createMsg(void);   // 组装消息并发送，收到应答返回 true
+    bool waitResponse(uint8_t function, int timeout_ms = LH08_TIMEOUT_MS);  // 等待应答
+    bool commit(void);      // 发送期望状态
+    void setDesired(uint8_t mask);
+    void workerLoop(void);
+
     int fd;  // 串口文件描述符
     std::vector<uint8_t> status = std::vector<uint8_t>(8);  // 存储8路继电器的状态
     std::vector<uint8_t> message;  // 命令消息
-    std::vector<uint8_t> recvMsg = std::vector<uint8_t>(13);  // 接收到的消息
-};
+    uint8_t recvMsg[LH08_FRAME_SIZE] = {};  // 接收到的消息
+    LH08Parser parser;  // 应答分帧器
 
+    // 状态缓存
+    std::mutex stateMutex;
+    std::condition_variable stateCv;
+    uint8_t desiredMask = 0;    // 期望状态
+    uint8_t appliedMask = 0;    // 继电器板最近一次应答确认的状态
+    bool appliedKnown = false;  // 是否已从继电器板获得过状态
+    bool pending = false;       // 是否有尚未发送的修改
+    std::chrono::steady_clock::time_point pendingSince;
+    std::atomic<int> coalesceMs{LH08_COALESCE_MS};
+    std::atomic<uint64_t> writeCount{0};
+    std::atomic<uint64_t> suppressedCount{0};
+    std::atomic<int64_t> roundTripUs{LH08_TIMEOUT_MS * 1000 / 4};  // 初值按超时的1/4保守估计
 
+    std::mutex ioMutex;  // 串口收发串行化
+    std::atomic<bool> running{false};
+    std::thread worker;
+};
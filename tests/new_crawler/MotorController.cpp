@@ -20,10 +20,10 @@ bool MotorController::stop_motor()
     return send_command(0x81); // 停止命令
 }
 
-bool MotorController::set_speed(int32_t target_speed_dps)
+// 协议单位为 0.01dps/LSB，传入 units::Dps 时隐式无损换算
+bool MotorController::set_speed(units::CentiDps target_speed)
 {
-    // 转换为协议单位 (0.01 dps/LSB)
-    int32_t speed_control = target_speed_dps * 100;
+    int32_t speed_control = target_speed.raw();
 
     uint8_t data[8] = {0};
     data[4] = static_cast<uint8_t>(speed_control);
@@ -2,6 +2,7 @@
 #define MOTOR_CONTROLLER_H
 
 #include "CANInterface.h"
+#include "motor_units.h"
 #include <cstdint>
 
 class MotorController
@@ -11,7 +12,7 @@ public:
     bool enable_motor();
     bool disable_motor();
     bool stop_motor();
-    bool set_speed(int32_t target_speed_dps);
+    bool set_speed(units::CentiDps target_speed);
 
 private:
     CANInterface &can_interface_;
@@ -12,6 +12,7 @@
 #include "CANInterface.h"
 #include "MotorController.h"
 #include "LH08Controller.h"
+#include "DirectionExecutor.h"
 
 // 将字符串转换为小写
 static std::string to_lower(const std::string &str)
@@ -527,17 +528,13 @@ static std::string read_command_with_history(std::vector<std::string> &history,
     return current_line;
 }
 
+// 设置方向继电器：与缓存状态相同时不访问串口，有变化时立即提交
 static void control_relay(LH08Controller &lh08, bool state)
 {
-    if (state)
+    if (lh08.setStatus(1, state ? 0x02 : 0x01))
     {
-        std::cout << "继电器开." << std::endl;
-        lh08.setStatus(1, 0x02);
-    }
-    else
-    {
-        std::cout << "继电器关." << std::endl;
-        lh08.setStatus(1, 0x01);
+        std::cout << (state ? "继电器开." : "继电器关.") << std::endl;
+        lh08.flush();
     }
 }
 
@@ -545,31 +542,13 @@ static void control_relay(LH08Controller &lh08, bool state)
 CANInterface* can_interface = nullptr;
 LH08Controller lh08;
 MotorController* motor = nullptr;
+DirectionExecutor* executor = nullptr;
 std::string command;
 
+// 换向时减速到零、切换继电器、再加速；继电器往返与减速过程重叠，速度符号不变时不切换继电器
 void move(int32_t speed)
 {
-    if (speed > 0)
-    {
-        // 正向速度
-        bool relay_state = g_move_config.positive_relay_on;
-        // std::cout << "正向移动，速度: " << speed << "，继电器: " << (relay_state ? "开" : "关") << std::endl;
-        control_relay(lh08, relay_state);
-    }
-    else if (speed < 0)
-    {
-        // 负向速度，继电器状态与正向相反
-        bool relay_state = !g_move_config.positive_relay_on;
-        // std::cout << "负向移动，速度: " << speed << "，继电器: " << (relay_state ? "开" : "关") << std::endl;
-        control_relay(lh08, relay_state);
-    }
-    else
-    {
-        // 零速度，不改变继电器状态
-        // std::cout << "零速/停止，速度: " << speed << "，继电器状态不变" << std::endl;
-    }
-    
-    motor->set_speed(speed);
+    executor->move(speed);
 }
 
 int main()
@@ -604,6 +583,12 @@ int main()
 
     motor->enable_motor();
 
+    // 方向 dir 对应的继电器状态：正向取配置值，负向取相反值
+    executor = new DirectionExecutor(*motor, lh08, [](int dir) {
+        return dir > 0 ? g_move_config.positive_relay_on : !g_move_config.positive_relay_on;
+    });
+    executor->start();
+
     std::cout << "Controller 已启动" << std::endl;
     std::cout << "输入 'help' 查看可用命令" << std::endl;
 
@@ -656,10 +641,12 @@ int main()
 
             if (relay_cmd == "on")
             {
+                executor->hold();
                 control_relay(lh08, true);
             }
             else if (relay_cmd == "off")
             {
+                executor->hold();
                 control_relay(lh08, false);
             }
             else
@@ -675,14 +662,17 @@ int main()
 
             if (motor_cmd == "stop")
             {
+                executor->hold();
                 motor->stop_motor();
             }
             else if (motor_cmd == "run")
             {
+                executor->hold();
                 motor->enable_motor();
             }
             else if (motor_cmd == "close")
             {
+                executor->hold();
                 motor->disable_motor();
             }
             else if (motor_cmd == "speed")
@@ -703,7 +693,7 @@ int main()
                 }
                 
                 std::cout << "设置电机速度为: " << speed << std::endl;
-                motor->set_speed(speed);
+                executor->setSpeed(speed);  // 由执行器线程下发，执行器暂停跟随 move 目标
             }
             else
             {
@@ -832,7 +822,8 @@ int main()
         }
         else if (cmd == "exit" || cmd == "quit")
         {
-            motor->set_speed(0);
+            delete executor;
+            motor->set_speed(units::Dps(0));
             motor->disable_motor();
             delete can_interface;
             delete motor;
@@ -846,7 +837,7 @@ int main()
             std::cout << "  motor stop - 停止电机" << std::endl;
             std::cout << "  motor run - 启动电机" << std::endl;
             std::cout << "  motor close - 关闭电机" << std::endl;
-            std::cout << "  motor speed <value> - 设置电机速度" << std::endl;
+            std::cout << "  motor speed <value> - 设置电机速度（不经换向逻辑，直到下一次 move）" << std::endl;
             std::cout << "  relay on - 打开继电器" << std::endl;
             std::cout << "  relay off - 关闭继电器" << std::endl;
             std::cout << "  config show - 显示当前配置" << std::endl;
@@ -0,0 +1,76 @@
+/**
+ * @file alloc_path_test.cpp
+ * @brief 控制路径堆分配测试
+ * @details 本测试以 ALLOC_COUNTER_ENABLED=1 编译 alloc_counter.cpp，统计全进程的堆分配。
+ *          按句柄发出速度闭环命令与状态2读取，读取缓存有效期设为0，保证每次都经过模拟总线往返；
+ *          预热之后，发送、等待应答、接收线程解析与发布遥测的整个区间内分配次数应为0
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "alloc_counter.h"
+#include "device_manager.h"
+#include "fake_can_bus.h"
+#include "logger.h"
+#include "test_check.h"
+
+int main()
+{
+    constexpr int WARMUP = 100;
+    constexpr int ROUNDS = 1000;
+
+    // 与运行时默认配置一致：文本日志 INFO 级别，DEBUG 日志不格式化
+    Logger::getInstance().setLevel(INFO);
+
+    FakeCanBus bus;
+    CHECK(bus.ok());
+    // 模拟总线上应答极快，放开遥测限流与降频，使每次读取都真正发帧
+    bus.interface().governor().setTelemetryRate(1e9, 1e9);
+    bus.interface().governor().setThresholds(2.0, 1.5);
+
+    DeviceManager dm;
+    CHECK(dm.addDevice<CANDevice>("motor_1", bus.interface()));
+    CANDevice* motor = dm.getDeviceAs<CANDevice>("motor_1");
+    CHECK(motor != nullptr);
+    if (!motor)
+    {
+        return testResult("alloc_path_test");
+    }
+    motor->setReadCacheTtl(0);
+    DeviceHandle handle = dm.getHandle("motor_1");
+    CHECK(handle.valid());
+
+    const MotorFrame speed = MotorCodec::SpeedControl::encode(12300); // 123 dps
+    const MotorFrame status = MotorCodec::GetStatus2::encode();
+    auto roundTrip = [&]() {
+        bool ok = dm.sendCommand(handle, speed[0], speed.data() + 1);
+        return dm.sendCommand(handle, status[0], nullptr) && ok;
+    };
+
+    for (int i = 0; i < WARMUP; i++)
+    {
+        roundTrip();
+    }
+
+    uint64_t frames = bus.frames();
+    int replied = 0;
+    AllocScope scope;
+    for (int i = 0; i < ROUNDS; i++)
+    {
+        replied += roundTrip();
+    }
+    uint64_t allocations = scope.allocations();
+
+    std::printf("往返 %d 次 (成功 %d)，总线帧 %llu，堆分配 %llu 次\n", ROUNDS, replied,
+                static_cast<unsigned long long>(bus.frames() - frames),
+                static_cast<unsigned long long>(allocations));
+    CHECK(AllocCounter::enabled());
+    CHECK(replied == ROUNDS);
+    CHECK(bus.frames() - frames == 2u * ROUNDS); // 读取没有命中缓存或被限流
+    CHECK(allocations == 0);
+
+    MotorTelemetry telemetry = motor->getTelemetry();
+    CHECK(telemetry.status2.speed == 123);
+    CHECK(telemetry.status2.encoder == FakeCanBus::ENCODER);
+
+    return testResult("alloc_path_test");
+}
@@ -0,0 +1,178 @@
+/**
+ * @file broadcast_ring_test.cpp
+ * @brief 广播环测试
+ * @details 单线程检查溢出计数；多线程压力测试中一个生产者发布 PUBLISHES 条样本，
+ *          三个读取速度不同的订阅者同时读取，检查：
+ *          - 读到的样本没有撕裂（样本内各字都由同一序号生成）
+ *          - 每个订阅者读到的序号严格递增，且与游标的丢失计数衔接
+ *          - 每个订阅者读到的条数加丢失条数等于发布条数
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "broadcast_ring.h"
+#include "test_check.h"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t PUBLISHES = 20000000;
+
+struct Sample {
+    uint64_t seq;
+    uint64_t words[6];
+};
+
+using Ring = BroadcastRing<Sample, 256>;
+
+Sample makeSample(uint64_t seq)
+{
+    Sample s;
+    s.seq = seq;
+    for (uint64_t i = 0; i < 6; i++)
+    {
+        s.words[i] = seq * 0x9E3779B97F4A7C15ULL + i;
+    }
+    return s;
+}
+
+bool intact(const Sample& s)
+{
+    for (uint64_t i = 0; i < 6; i++)
+    {
+        if (s.words[i] != s.seq * 0x9E3779B97F4A7C15ULL + i)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 订阅者统计
+struct Reader {
+    uint64_t received = 0;
+    uint64_t torn = 0;
+    uint64_t outOfOrder = 0;
+    uint64_t dropped = 0;
+    uint64_t overruns = 0;
+};
+
+void overflowAccounting()
+{
+    Ring ring;
+    Ring::Cursor cursor = ring.subscribe();
+    Sample s;
+    CHECK(!ring.read(cursor, s));
+
+    for (uint64_t i = 0; i < Ring::capacity() + 10; i++)
+    {
+        ring.publish(makeSample(i));
+    }
+    CHECK(ring.backlog(cursor) == Ring::capacity() + 10);
+    CHECK(ring.read(cursor, s));
+    CHECK(s.seq == 10);
+    CHECK(cursor.dropped() == 10);
+    CHECK(cursor.overruns() == 1);
+
+    uint64_t count = 1;
+    while (ring.read(cursor, s))
+    {
+        count++;
+    }
+    CHECK(count == Ring::capacity());
+    CHECK(s.seq == Ring::capacity() + 9);
+
+    // 之后新建的订阅只看到此后发布的数据
+    Ring::Cursor late = ring.subscribe();
+    CHECK(!ring.read(late, s));
+    ring.publish(makeSample(1000));
+    CHECK(ring.read(late, s) && s.seq == 1000);
+}
+
+void concurrentStress()
+{
+    Ring ring;
+    std::atomic<bool> done{false};
+    std::vector<Reader> readers(3);
+    std::vector<std::thread> threads;
+
+    for (size_t r = 0; r < readers.size(); r++)
+    {
+        // 订阅在生产者启动之前完成，游标从第0条开始
+        threads.emplace_back([&ring, &done, &reader = readers[r], r, cursor = ring.subscribe()]() mutable {
+            Sample s;
+            uint64_t expected = 0;
+            for (;;)
+            {
+                bool finished = done.load(std::memory_order_acquire);
+                if (!ring.read(cursor, s))
+                {
+                    if (finished)
+                    {
+                        break;
+                    }
+                    continue;
+                }
+                reader.received++;
+                if (!intact(s))
+                {
+                    reader.torn++;
+                }
+                // 读到的序号必须等于上一条之后的位置加上这期间丢失的条数
+                if (s.seq != expected + (cursor.dropped() - reader.dropped))
+                {
+                    reader.outOfOrder++;
+                }
+                reader.dropped = cursor.dropped();
+                expected = s.seq + 1;
+                // 订阅者1偶尔让出CPU，订阅者2每读64条休眠一次，制造落后与覆盖
+                if (r == 1 && (reader.received & 0xFF) == 0)
+                {
+                    std::this_thread::yield();
+                }
+                else if (r == 2 && (reader.received & 0x3F) == 0)
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+            reader.dropped = cursor.dropped();
+            reader.overruns = cursor.overruns();
+        });
+    }
+
+    for (uint64_t i = 0; i < PUBLISHES; i++)
+    {
+        ring.publish(makeSample(i));
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    CHECK(ring.published() == PUBLISHES);
+    for (size_t r = 0; r < readers.size(); r++)
+    {
+        const Reader& reader = readers[r];
+        std::printf("订阅者%zu: 读取 %llu 丢失 %llu 溢出 %llu 撕裂 %llu 乱序 %llu\n", r,
+                    static_cast<unsigned long long>(reader.received),
+                    static_cast<unsigned long long>(reader.dropped),
+                    static_cast<unsigned long long>(reader.overruns),
+                    static_cast<unsigned long long>(reader.torn),
+                    static_cast<unsigned long long>(reader.outOfOrder));
+        CHECK(reader.torn == 0);
+        CHECK(reader.outOfOrder == 0);
+        CHECK(reader.received + reader.dropped == PUBLISHES);
+    }
+    CHECK(readers[2].dropped > 0); // 慢订阅者确实发生过覆盖
+}
+
+} // namespace
+
+int main()
+{
+    overflowAccounting();
+    concurrentStress();
+    return testResult("broadcast_ring_test");
+}
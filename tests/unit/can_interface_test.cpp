@@ -0,0 +1,69 @@
+/**
+ * @file can_interface_test.cpp
+ * @brief CAN 接口接收线程测试
+ * @details CANInterface 经 attachSocket 接管 socketpair 的一端，检查：
+ *          - 完整的帧分发给对应 CAN ID 的接收回调
+ *          - 不完整的帧不分发
+ *          - 对端关闭后接收线程退出，不再重复分发旧帧
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "can_interface.h"
+#include "logger.h"
+#include "test_check.h"
+#include <chrono>
+#include <thread>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+template <typename Pred>
+bool waitFor(Pred pred, int timeout_ms = 1000)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!pred())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+int main()
+{
+    Logger::getInstance().setLevel(INFO);
+
+    int fds[2];
+    CHECK(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) == 0);
+    CANInterface can("fake");
+    CHECK(can.attachSocket(fds[0]));
+
+    std::atomic<int> received{0};
+    can.addReceiver(0x141, [&](const struct can_frame&) { received++; });
+
+    struct can_frame frame = {};
+    frame.can_id = 0x141;
+    frame.can_dlc = 8;
+    CHECK(write(fds[1], &frame, sizeof(frame)) == static_cast<ssize_t>(sizeof(frame)));
+    CHECK(waitFor([&] { return received == 1; }));
+
+    // 不完整的帧丢弃
+    CHECK(write(fds[1], &frame, 4) == 4);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(received == 1);
+    CHECK(can.isReceiving());
+
+    // 对端关闭：接收线程退出
+    close(fds[1]);
+    CHECK(waitFor([&] { return !can.isReceiving(); }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(received == 1);
+
+    return testResult("can_interface_test");
+}
@@ -0,0 +1,192 @@
+/**
+ * @file device_event_bus_test.cpp
+ * @brief 设备事件总线测试
+ * @details 检查：
+ *          - 订阅者只收到与过滤条件匹配的事件，回调在总线线程中执行
+ *          - 订阅者阻塞时投递不等待：队列满后的事件被丢弃并计数
+ *          - unsubscribe() 返回后回调不再执行
+ *          - 自动清错：电机错误标志由0变为非0时下发一次清除错误命令，故障持续时不重复下发
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "device_event_bus.h"
+#include "device_manager.h"
+#include "fake_can_bus.h"
+#include "global_config.h"
+#include "logger.h"
+#include "test_check.h"
+#include <chrono>
+#include <thread>
+
+namespace {
+
+template <typename Pred>
+bool waitFor(Pred pred, int timeout_ms = 1000)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!pred())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+void filtering(DeviceEventBus& bus)
+{
+    std::atomic<int> matched{0};
+    std::atomic<int> wrong{0};
+    std::atomic<bool> onBusThread{true};
+    std::thread::id caller = std::this_thread::get_id();
+
+    DeviceEventFilter filter;
+    filter.deviceId = "motor_1";
+    filter.typeMask = eventMask(DeviceEventType::TIMEOUT) | eventMask(DeviceEventType::ERROR_FLAGS);
+    uint64_t id = bus.subscribe(filter, [&](const DeviceEvent& event) {
+        if (event.deviceId == "motor_1" && event.type != DeviceEventType::STATUS_CHANGED && event.timestamp_ns != 0)
+        {
+            matched++;
+        }
+        else
+        {
+            wrong++;
+        }
+        if (std::this_thread::get_id() == caller)
+        {
+            onBusThread = false;
+        }
+    });
+
+    CHECK(bus.postTimeout("motor_1", 0x9C));
+    CHECK(bus.postErrorFlags("motor_1", 0x08, 0x00));
+    CHECK(bus.postStatus("motor_1", DeviceStatus::ERROR));  // 类型不匹配
+    CHECK(bus.postTimeout("motor_2", 0x9C));                // 设备不匹配
+    CHECK(waitFor([&] { return matched == 2; }));
+    // 不匹配的事件排在匹配事件之后，再投递一个匹配事件确认前面的都已分发
+    CHECK(bus.postTimeout("motor_1", 0x9A));
+    CHECK(waitFor([&] { return matched == 3; }));
+    CHECK(wrong == 0);
+    CHECK(onBusThread);
+    bus.unsubscribe(id);
+}
+
+void overflowDoesNotBlock(DeviceEventBus& bus)
+{
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    DeviceEventFilter filter;
+    filter.deviceId = "blocker_1";
+    uint64_t id = bus.subscribe(filter, [&](const DeviceEvent&) {
+        entered = true;
+        while (!release)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    CHECK(bus.postTimeout("blocker_1", 0));
+    CHECK(waitFor([&] { return entered.load(); }));
+
+    // 分发线程被占住：队列装满 DEVICE_EVENT_QUEUE_CAPACITY 条后，其余投递立即失败
+    uint64_t dropped = bus.getDroppedCount();
+    int rejected = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < DEVICE_EVENT_QUEUE_CAPACITY + 100; i++)
+    {
+        rejected += !bus.postTimeout("overflow_1", 0);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    CHECK(rejected == 100);
+    CHECK(bus.getDroppedCount() - dropped == 100);
+    CHECK(elapsed < std::chrono::milliseconds(500));
+
+    release = true;
+    bus.unsubscribe(id);
+}
+
+void unsubscribeWaitsForDispatch(DeviceEventBus& bus)
+{
+    std::atomic<int> calls{0};
+    std::atomic<bool> inside{false};
+    DeviceEventFilter filter;
+    filter.deviceId = "slow_1";
+    uint64_t id = bus.subscribe(filter, [&](const DeviceEvent&) {
+        inside = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        calls++;
+        inside = false;
+    });
+
+    CHECK(bus.postTimeout("slow_1", 0));
+    CHECK(waitFor([&] { return inside.load(); }));
+    bus.unsubscribe(id);
+    CHECK(!inside);           // 返回时正在执行的回调已结束
+    int seen = calls;
+    CHECK(bus.postTimeout("slow_1", 0));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(calls == seen);     // 之后的事件不再回调
+}
+
+void autoClearError()
+{
+    FakeCanBus can;
+    CHECK(can.ok());
+    can.interface().governor().setTelemetryRate(1e9, 1e9);
+
+    DeviceManager dm;
+    CHECK(dm.addDevice<CANDevice>("motor_1", can.interface()));
+    CANDevice* motor = dm.getDeviceAs<CANDevice>("motor_1");
+    if (!motor)
+    {
+        CHECK(motor != nullptr);
+        return;
+    }
+    motor->setReadCacheTtl(0);
+    dm.setAutoClearError(true);
+
+    const uint8_t getStatus1 = MotorCodec::GetStatus1::command;
+    const uint8_t clearError = MotorCodec::ClearError::command;
+    CHECK(motor->sendCommand(getStatus1));
+    CHECK(can.frames(clearError) == 0);
+
+    // 标志由0变为非0：总线线程下发一次清除错误命令
+    can.setErrorState(0x08);
+    CHECK(motor->sendCommand(getStatus1));
+    CHECK(waitFor([&] { return can.frames(clearError) == 1; }));
+
+    // 故障持续，标志不变：不再产生事件，也不重复清错
+    for (int i = 0; i < 5; i++)
+    {
+        CHECK(motor->sendCommand(getStatus1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5 * DEVICE_EVENT_POLL_MS));
+    CHECK(can.frames(clearError) == 1);
+
+    // 故障消失后再次出现：再清一次
+    can.setErrorState(0x00);
+    CHECK(motor->sendCommand(getStatus1));
+    can.setErrorState(0x08);
+    CHECK(motor->sendCommand(getStatus1));
+    CHECK(waitFor([&] { return can.frames(clearError) == 2; }));
+
+    dm.setAutoClearError(false);
+}
+
+} // namespace
+
+int main()
+{
+    Logger::getInstance().setLevel(INFO);
+    DeviceEventBus& bus = DeviceEventBus::getInstance();
+    bus.start();
+
+    filtering(bus);
+    overflowDoesNotBlock(bus);
+    unsubscribeWaitsForDispatch(bus);
+    autoClearError();
+
+    return testResult("device_event_bus_test");
+}
@@ -0,0 +1,103 @@
+/**
+ * @file fake_can_bus.h
+ * @brief 单元测试用模拟 CAN 总线
+ * @details CANInterface 通过 attachSocket 接管 socketpair 的一端，另一端由应答线程模拟电机：
+ *          每收到一帧按 MotorCodec::replyTable 的响应布局回一帧，CAN ID 与命令字节不变
+ *          - 状态2布局（0x9C 与各闭环控制命令）填入固定的温度、转矩电流、编码器，转速取最近一次 0xA2 的设定值
+ *          - 状态1布局（0x9A、0x9B）的错误标志取 setErrorState() 设置的值，清除错误命令不改变它（模拟持续故障）
+ *          - 其它命令回显请求帧
+ *          - 按命令字节统计收到的帧数
+ *          - 应答线程只做定长读写，不分配内存
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "can_interface.h"
+#include "motor_codec.h"
+
+class FakeCanBus {
+public:
+    static constexpr int8_t TEMPERATURE = 40;
+    static constexpr int16_t CURRENT = 100;
+    static constexpr uint16_t ENCODER = 0x1234;
+
+    FakeCanBus() : can_("fake")
+    {
+        if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds_) != 0 || !can_.attachSocket(fds_[0]))
+        {
+            fds_[1] = -1;
+            return;
+        }
+        thread_ = std::thread(&FakeCanBus::respond, this);
+    }
+
+    ~FakeCanBus()
+    {
+        if (fds_[1] >= 0)
+        {
+            shutdown(fds_[1], SHUT_RDWR);
+            thread_.join();
+            close(fds_[1]);
+        }
+    }
+
+    bool ok() const { return fds_[1] >= 0; }
+    CANInterface& interface() { return can_; }
+    uint64_t frames() const { return frames_.load(std::memory_order_acquire); }
+    uint32_t frames(uint8_t command) const { return commandFrames_[command].load(std::memory_order_acquire); }
+    void setErrorState(uint8_t errorState) { errorState_.store(errorState, std::memory_order_relaxed); }
+
+private:
+    void respond()
+    {
+        struct can_frame frame;
+        while (read(fds_[1], &frame, sizeof(frame)) == static_cast<ssize_t>(sizeof(frame)))
+        {
+            MotorFrame data;
+            for (size_t i = 0; i < data.size(); i++)
+            {
+                data[i] = frame.data[i];
+            }
+            if (data[0] == MotorCodec::SpeedControl::command)
+            {
+                speed_ = static_cast<int16_t>(MotorField<int32_t, 4>::get(data.data()) / 100);
+            }
+            if (MotorCodec::replyTable[data[0]] == MotorReplyLayout::STATUS2)
+            {
+                Status2Reply::Temperature::put(data, TEMPERATURE);
+                Status2Reply::Current::put(data, CURRENT);
+                Status2Reply::Speed::put(data, speed_);
+                Status2Reply::Encoder::put(data, ENCODER);
+            }
+            else if (MotorCodec::replyTable[data[0]] == MotorReplyLayout::STATUS1)
+            {
+                Status1Reply::Temperature::put(data, TEMPERATURE);
+                Status1Reply::Error::put(data, errorState_.load(std::memory_order_relaxed));
+            }
+            for (size_t i = 0; i < data.size(); i++)
+            {
+                frame.data[i] = data[i];
+            }
+            commandFrames_[frame.data[0]].fetch_add(1, std::memory_order_release);
+            frames_.fetch_add(1, std::memory_order_release);
+            if (write(fds_[1], &frame, sizeof(frame)) != static_cast<ssize_t>(sizeof(frame)))
+            {
+                break;
+            }
+        }
+    }
+
+    CANInterface can_;
+    int fds_[2] = {-1, -1};
+    std::thread thread_;
+    std::atomic<uint64_t> frames_{0};
+    std::array<std::atomic<uint32_t>, 256> commandFrames_{};
+    std::atomic<uint8_t> errorState_{0};
+    int16_t speed_ = 0; // 仅应答线程访问
+};
@@ -0,0 +1,85 @@
+/**
+ * @file poll_scheduler_test.cpp
+ * @brief 遥测轮询调度器测试
+ * @details 在模拟 CAN 总线上轮询两台电机的状态2，检查：
+ *          - 轮询项按设备句柄添加，请求得到响应
+ *          - 设备被 DeviceManager 移除后，其轮询项被删除，调度器不再访问该设备，另一台照常轮询
+ *          - 无效句柄不能添加
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "device_manager.h"
+#include "fake_can_bus.h"
+#include "logger.h"
+#include "poll_scheduler.h"
+#include "test_check.h"
+#include <chrono>
+#include <thread>
+
+namespace {
+
+template <typename Pred>
+bool waitFor(Pred pred, int timeout_ms = 2000)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!pred())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+uint64_t answered(const PollScheduler& scheduler, const std::string& id)
+{
+    for (const auto& stats : scheduler.getStats())
+    {
+        if (stats.deviceId == id)
+        {
+            return stats.answered;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+int main()
+{
+    Logger::getInstance().setLevel(INFO);
+
+    FakeCanBus bus;
+    CHECK(bus.ok());
+    bus.interface().governor().setTelemetryRate(1e9, 1e9);
+    bus.interface().governor().setThresholds(2.0, 1.5);
+
+    DeviceManager dm;
+    CHECK(dm.addDevice<CANDevice>("motor_1", bus.interface()));
+    CHECK(dm.addDevice<CANDevice>("motor_2", bus.interface()));
+    DeviceHandle motor1 = dm.getHandle("motor_1");
+    DeviceHandle motor2 = dm.getHandle("motor_2");
+
+    PollScheduler scheduler(dm, bus.interface());
+    CHECK(scheduler.addPoll(motor1, MOTOR_GET_STATUS2, 500.0));
+    CHECK(scheduler.addPoll(motor2, MOTOR_GET_STATUS2, 500.0));
+    CHECK(!scheduler.addPoll(DeviceHandle{}, MOTOR_GET_STATUS2, 500.0));
+    CHECK(scheduler.start());
+
+    CHECK(waitFor([&] { return answered(scheduler, "motor_1") >= 10 && answered(scheduler, "motor_2") >= 10; }));
+
+    // 移除设备后旧句柄失效，轮询项随之删除
+    CHECK(dm.removeDevice("motor_1"));
+    CHECK(waitFor([&] { return scheduler.getStats().size() == 1; }));
+    std::vector<PollScheduler::PollStats> stats = scheduler.getStats();
+    CHECK(stats.size() == 1 && stats[0].deviceId == "motor_2");
+
+    uint64_t before = answered(scheduler, "motor_2");
+    CHECK(waitFor([&] { return answered(scheduler, "motor_2") >= before + 10; }));
+    CHECK(!scheduler.addPoll(motor1, MOTOR_GET_STATUS2, 500.0));
+
+    scheduler.stop();
+    return testResult("poll_scheduler_test");
+}
@@ -0,0 +1,64 @@
+/**
+ * @file telemetry_store_test.cpp
+ * @brief 全车遥测数据表测试
+ * @details 两条模拟 CAN 总线上各有一台电机ID为1的电机，检查：
+ *          - 两台电机按 DeviceManager 分配的句柄各占一行，互不覆盖
+ *          - 移除其中一台只清除它自己的行
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "device_manager.h"
+#include "fake_can_bus.h"
+#include "logger.h"
+#include "telemetry_store.h"
+#include "test_check.h"
+
+int main()
+{
+    Logger::getInstance().setLevel(INFO);
+
+    FakeCanBus leftBus;
+    FakeCanBus rightBus;
+    CHECK(leftBus.ok() && rightBus.ok());
+    leftBus.setErrorState(0x00);
+    rightBus.setErrorState(0x04);
+
+    DeviceManager dm;
+    dm.setAutoClearError(false);
+    CHECK(dm.addDevice<CANDevice>("left_1", leftBus.interface()));
+    CHECK(dm.addDevice<CANDevice>("right_1", rightBus.interface()));
+    CANDevice* left = dm.getDeviceAs<CANDevice>("left_1");
+    CANDevice* right = dm.getDeviceAs<CANDevice>("right_1");
+    if (!left || !right)
+    {
+        CHECK(left && right);
+        return testResult("telemetry_store_test");
+    }
+    CHECK(left->getNode() == right->getNode());
+    int leftSlot = left->getTelemetrySlot();
+    int rightSlot = right->getTelemetrySlot();
+    CHECK(leftSlot >= 0 && rightSlot >= 0 && leftSlot != rightSlot);
+
+    const uint8_t getStatus1 = MotorCodec::GetStatus1::command;
+    CHECK(left->sendCommand(getStatus1));
+    CHECK(right->sendCommand(getStatus1));
+
+    TelemetryStore& store = TelemetryStore::getInstance();
+    TelemetryStore::Table table = store.snapshot();
+    CHECK(table.status1Mask == ((1ull << leftSlot) | (1ull << rightSlot)));
+    CHECK(table.errorState[leftSlot] == 0x00);
+    CHECK(table.errorState[rightSlot] == 0x04);
+    CHECK(table.temperature[leftSlot] == FakeCanBus::TEMPERATURE);
+    CHECK(store.health().deviceCount == 2);
+    CHECK(store.health().errorMask == (1ull << rightSlot));
+
+    // 移除一台只清除它自己的行
+    CHECK(dm.removeDevice("right_1"));
+    table = store.snapshot();
+    CHECK(table.status1Mask == (1ull << leftSlot));
+    CHECK(table.temperature[leftSlot] == FakeCanBus::TEMPERATURE);
+    CHECK(table.temperature[rightSlot] == TelemetryStore::INVALID_TEMPERATURE);
+    CHECK(store.health().errorMask == 0);
+
+    return testResult("telemetry_store_test");
+}
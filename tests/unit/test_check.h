@@ -0,0 +1,38 @@
+/**
+ * @file test_check.h
+ * @brief 单元测试断言
+ * @details 不依赖测试框架：CHECK 失败时打印位置并计数，main 以 testResult() 作为退出码，由 ctest 判定
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#pragma once
+#include <cstdio>
+
+inline int& testFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        std::printf("%s:%d: 检查失败: %s\n", __FILE__, __LINE__, #cond); \
+        testFailures()++; \
+    } \
+} while (0)
+
+/**
+ * @brief 汇总检查结果
+ * @param name 测试名称
+ * @return int 全部通过返回0，否则返回1
+ */
+inline int testResult(const char* name)
+{
+    if (testFailures() != 0)
+    {
+        std::printf("%s: %d 项检查失败\n", name, testFailures());
+        return 1;
+    }
+    std::printf("%s: 全部通过\n", name);
+    return 0;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file trajectory_engine_test.cpp
+ * @brief 位置轨迹下发引擎测试
+ * @details 不启动引擎自身的下发线程，由测试逐周期调用 tick()；
+ *          两条轨迹分别用 0xA3（maxSpeed 为0）与 0xA4 下发，按模拟总线上各命令的帧数区分下发的是哪一条。检查：
+ *          - 循环轨迹在装载非抢占的新轨迹后，于当前一圈结束时切换，之后不再下发旧轨迹
+ *          - 抢占装载在下一个周期立即切换
+ *          - 非循环轨迹结束且没有后续轨迹时计入 underruns 并转为空闲
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "device_manager.h"
+#include "fake_can_bus.h"
+#include "logger.h"
+#include "test_check.h"
+#include "trajectory_engine.h"
+#include <chrono>
+#include <thread>
+
+namespace {
+
+const uint8_t LOOP_COMMAND = MotorCodec::MultiPositionControl1::command;
+const uint8_t NEXT_COMMAND = MotorCodec::MultiPositionControl2::command;
+
+template <typename Pred>
+bool waitFor(Pred pred, int timeout_ms = 1000)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!pred())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// 逐周期推进，并等待模拟总线收到本周期发出的帧
+void tickAndWait(TrajectoryEngine& engine, FakeCanBus& bus, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        uint64_t frames = bus.frames();
+        CHECK(engine.tick());
+        CHECK(waitFor([&] { return bus.frames() == frames + 1; }));
+    }
+}
+
+} // namespace
+
+int main()
+{
+    Logger::getInstance().setLevel(INFO);
+
+    FakeCanBus bus;
+    CHECK(bus.ok());
+    bus.interface().governor().setThresholds(2.0, 1.5);
+
+    DeviceManager dm;
+    CHECK(dm.addDevice<CANDevice>("motor_1", bus.interface()));
+    CANDevice* motor = dm.getDeviceAs<CANDevice>("motor_1");
+    CHECK(motor != nullptr);
+    if (!motor)
+    {
+        return testResult("trajectory_engine_test");
+    }
+
+    const std::vector<Waypoint> loopPath = {{0, 0}, {1000, 0}, {2000, 0}};
+    const std::vector<Waypoint> nextPath = {{3000, 500}, {4000, 500}};
+    TrajectoryEngine engine(*motor, 100.0, 8);
+
+    // 循环轨迹跑过一圈多之后装载非抢占轨迹：当前一圈剩余的两个路点下发完再切换
+    CHECK(engine.load(loopPath, true));
+    tickAndWait(engine, bus, 4);
+    CHECK(engine.getIndex() == 1);
+    CHECK(engine.load(nextPath));
+    tickAndWait(engine, bus, 2);
+    CHECK(bus.frames(LOOP_COMMAND) == 6);
+    CHECK(engine.getStats().swaps == 2);
+    CHECK(engine.getIndex() == 0);
+
+    tickAndWait(engine, bus, 2);
+    CHECK(bus.frames(LOOP_COMMAND) == 6);
+    CHECK(bus.frames(NEXT_COMMAND) == 2);
+    CHECK(engine.isIdle());
+    CHECK(engine.getStats().underruns == 1);
+
+    // 空闲时不再下发
+    uint64_t frames = bus.frames();
+    CHECK(engine.tick());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(bus.frames() == frames);
+
+    // 抢占：循环轨迹执行到中途，下一个周期即下发新轨迹的第一个路点
+    CHECK(engine.load(loopPath, true));
+    tickAndWait(engine, bus, 2);
+    CHECK(engine.load(nextPath, false, true));
+    tickAndWait(engine, bus, 1);
+    CHECK(bus.frames(LOOP_COMMAND) == 8);
+    CHECK(bus.frames(NEXT_COMMAND) == 3);
+    CHECK(engine.getIndex() == 1);
+    CHECK(engine.getStats().swaps == 4);
+
+    TrajectoryEngine::TrajectoryStats stats = engine.getStats();
+    CHECK(stats.ticks == 11);
+    CHECK(stats.sendFailures == 0);
+
+    return testResult("trajectory_engine_test");
+}
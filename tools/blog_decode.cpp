@@ -0,0 +1,184 @@
+/**
+ * @file blog_decode.cpp
+ * @brief 二进制日志解码工具
+ * @details 将 BinaryLogger 写出的 logs/<name>.bin 还原为与文本日志相同的格式：
+ *          [YYYY-MM-DD HH:MM:SS] [LEVEL] message
+ *          用法: blog_decode [file.bin ...]，不带参数时按修改时间从旧到新解码 logs/ 下所有 .bin 分段
+ * @author zakiu
+ * @date 2026-10-18
+ */
+#include "binary_logger.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <unordered_map>
+
+static const char* levelToString(uint8_t level) {
+    switch (level) {
+        case DEBUG: return "DEBUG";
+        case INFO: return "INFO";
+        case WARNING: return "WARNING";
+        case ERROR: return "ERROR";
+        case CRITICAL: return "CRITICAL";
+        default: return "UNKNOWN";
+    }
+}
+
+/**
+ * @brief 按格式串展开整型参数
+ * @details 逐个解析转换说明，长度修饰统一替换为 ll 后交给 snprintf
+ */
+static std::string formatMessage(const std::string& format, const int64_t* args, int nargs) {
+    std::string out;
+    int argIndex = 0;
+    for (size_t i = 0; i < format.size(); i++) {
+        if (format[i] != '%') {
+            out += format[i];
+            continue;
+        }
+        if (i + 1 < format.size() && format[i + 1] == '%') {
+            out += '%';
+            i++;
+            continue;
+        }
+
+        // 标志、宽度、精度
+        size_t j = i + 1;
+        while (j < format.size() && std::strchr("-+ #0123456789.", format[j])) {
+            j++;
+        }
+        std::string spec = format.substr(i, j - i);
+        // 跳过长度修饰
+        while (j < format.size() && std::strchr("hlzjt", format[j])) {
+            j++;
+        }
+        if (j >= format.size()) {
+            out += format.substr(i);
+            break;
+        }
+
+        char conv = format[j];
+        char buf[64];
+        int64_t value = argIndex < nargs ? args[argIndex] : 0;
+        switch (conv) {
+            case 'd':
+            case 'i':
+                std::snprintf(buf, sizeof(buf), (spec + "lld").c_str(), static_cast<long long>(value));
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+                std::snprintf(buf, sizeof(buf), (spec + "ll" + conv).c_str(), static_cast<unsigned long long>(value));
+                break;
+            case 'c':
+                std::snprintf(buf, sizeof(buf), (spec + "c").c_str(), static_cast<int>(value));
+                break;
+            default:
+                std::snprintf(buf, sizeof(buf), "%s", format.substr(i, j - i + 1).c_str());
+                argIndex--;
+                break;
+        }
+        argIndex++;
+        out += buf;
+        i = j;
+    }
+    return out;
+}
+
+template <typename T>
+static bool readValue(std::FILE* file, T& value) {
+    return std::fread(&value, sizeof(T), 1, file) == 1;
+}
+
+static bool decodeFile(const std::string& filename) {
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if (!file) {
+        std::cerr << "无法打开文件: " << filename << std::endl;
+        return false;
+    }
+
+    char magic[sizeof(BLOG_MAGIC)];
+    if (std::fread(magic, 1, sizeof(magic), file) != sizeof(magic) || std::memcmp(magic, BLOG_MAGIC, sizeof(magic)) != 0) {
+        std::cerr << "不是二进制日志文件: " << filename << std::endl;
+        std::fclose(file);
+        return false;
+    }
+
+    // 同一文件中可能包含多次运行的记录，后出现的格式描述覆盖同编号的旧描述
+    std::unordered_map<uint32_t, std::pair<uint8_t, std::string>> sites;
+    uint8_t type;
+    while (readValue(file, type)) {
+        if (type == BLOG_RECORD_SITE) {
+            uint32_t id;
+            uint8_t level;
+            uint16_t length;
+            if (!readValue(file, id) || !readValue(file, level) || !readValue(file, length)) {
+                break;
+            }
+            std::string format(length, '\0');
+            if (std::fread(&format[0], 1, length, file) != length) {
+                break;
+            }
+            sites[id] = {level, format};
+        } else if (type == BLOG_RECORD_LOG) {
+            uint32_t id;
+            int64_t timeNs;
+            uint8_t nargs;
+            int64_t args[BinaryLogger::MAX_ARGS];
+            if (!readValue(file, id) || !readValue(file, timeNs) || !readValue(file, nargs) || nargs > BinaryLogger::MAX_ARGS ||
+                std::fread(args, sizeof(int64_t), nargs, file) != nargs) {
+                break;
+            }
+
+            std::time_t seconds = static_cast<std::time_t>(timeNs / 1000000000);
+            std::tm tm;
+            localtime_r(&seconds, &tm);
+            char timestamp[32];
+            std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &tm);
+
+            auto it = sites.find(id);
+            if (it == sites.end()) {
+                std::cout << "[" << timestamp << "] [UNKNOWN] <未知调用点 " << id << ">\n";
+                continue;
+            }
+            std::cout << "[" << timestamp << "] [" << levelToString(it->second.first) << "] "
+                      << formatMessage(it->second.second, args, nargs) << "\n";
+        } else {
+            std::cerr << "文件损坏: " << filename << " 偏移 " << std::ftell(file) - 1 << std::endl;
+            break;
+        }
+    }
+
+    std::fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        files.push_back(argv[i]);
+    }
+    if (files.empty() && std::filesystem::exists("logs")) {
+        for (const auto& entry : std::filesystem::directory_iterator("logs")) {
+            if (entry.path().extension() == ".bin") {
+                files.push_back(entry.path().string());
+            }
+        }
+        // 滚动后的历史分段编号越大越旧，按修改时间排序即为时间顺序
+        std::sort(files.begin(), files.end(), [](const std::string& a, const std::string& b) {
+            return std::filesystem::last_write_time(a) < std::filesystem::last_write_time(b);
+        });
+    }
+    if (files.empty()) {
+        std::cerr << "用法: " << argv[0] << " [file.bin ...]" << std::endl;
+        return 1;
+    }
+
+    bool ok = true;
+    for (const auto& filename : files) {
+        ok = decodeFile(filename) && ok;
+    }
+    return ok ? 0 : 1;
+}